@@ -0,0 +1,91 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+
+
+namespace ftss
+{
+    // A queue between two threads that holds at most capacity items. Push
+    // blocks while it is full, which holds the producer back until the
+    // consumer catches up, and Pop blocks while it is empty.
+    template<typename T>
+    struct BoundedQueue
+    {
+        BoundedQueue(size_t capacity);
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // Fails once the queue is closed, the item is dropped then
+        bool Push(T&& item);
+
+        // Fails once the queue is closed and empty
+        bool Pop(T& item);
+
+        // Wakes up every waiting thread, nothing can be pushed afterwards
+        void Close();
+
+    private:
+        size_t m_capacity;
+        bool m_closed;
+        std::deque<T> m_items;
+        std::mutex m_mutex;
+        std::condition_variable m_notFull;
+        std::condition_variable m_notEmpty;
+    };
+
+    template<typename T>
+    inline BoundedQueue<T>::BoundedQueue(size_t capacity)
+        : m_capacity(capacity > 0 ? capacity : 1)
+        , m_closed(false)
+    {}
+
+    template<typename T>
+    inline bool BoundedQueue<T>::Push(T&& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed)
+        {
+            return false;
+        }
+        m_items.push_back(std::move(item));
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    template<typename T>
+    inline bool BoundedQueue<T>::Pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]() { return m_closed || !m_items.empty(); });
+        if (m_items.empty())
+        {
+            return false;
+        }
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    template<typename T>
+    inline void BoundedQueue<T>::Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+}
@@ -0,0 +1,118 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // Structure of arrays alternative to FontData for runtime lookups. A
+    // glyph is found through a 256 entry slot table instead of a hash map
+    // node and each metric is a dense 16 bit array indexed by that slot, so
+    // the metrics of a whole character set share a handful of cache lines.
+    // Bearings keep their sign, texture coordinates are normalized to
+    // 0..65535. See ConvertToCompactFontData and ConvertFromCompactFontData.
+    struct CompactFontData
+    {
+        static const unsigned short INVALID_SLOT = 0xFFFF;
+
+        CompactFontData();
+
+        void Clear();
+
+        unsigned short GetSlot(unsigned char character) const;
+        size_t GetGlyphCount() const;
+
+        bool operator==(const CompactFontData& other) const;
+        bool operator!=(const CompactFontData& other) const;
+
+        unsigned short lineSpacing_px;
+        unsigned short slotMap[256];
+
+        std::vector<unsigned char> characters;
+
+        std::vector<unsigned short> width_px;
+        std::vector<unsigned short> height_px;
+        std::vector<short> horiBearingX_px;
+        std::vector<short> horiBearingY_px;
+        std::vector<unsigned short> horiAdvance_px;
+        std::vector<short> vertBearingX_px;
+        std::vector<short> vertBearingY_px;
+        std::vector<unsigned short> vertAdvance_px;
+
+        std::vector<unsigned short> textureLeft;
+        std::vector<unsigned short> textureRight;
+        std::vector<unsigned short> textureBottom;
+        std::vector<unsigned short> textureTop;
+    };
+
+    inline CompactFontData::CompactFontData()
+        : lineSpacing_px(0)
+    {
+        for (unsigned int i = 0; i < 256; ++i)
+        {
+            slotMap[i] = INVALID_SLOT;
+        }
+    }
+
+    inline void CompactFontData::Clear()
+    {
+        lineSpacing_px = 0;
+        for (unsigned int i = 0; i < 256; ++i)
+        {
+            slotMap[i] = INVALID_SLOT;
+        }
+        characters.clear();
+        width_px.clear();
+        height_px.clear();
+        horiBearingX_px.clear();
+        horiBearingY_px.clear();
+        horiAdvance_px.clear();
+        vertBearingX_px.clear();
+        vertBearingY_px.clear();
+        vertAdvance_px.clear();
+        textureLeft.clear();
+        textureRight.clear();
+        textureBottom.clear();
+        textureTop.clear();
+    }
+
+    inline unsigned short CompactFontData::GetSlot(unsigned char character) const
+    {
+        return slotMap[character];
+    }
+
+    inline size_t CompactFontData::GetGlyphCount() const
+    {
+        return characters.size();
+    }
+
+    inline bool CompactFontData::operator==(const CompactFontData& other) const
+    {
+        return lineSpacing_px == other.lineSpacing_px &&
+            std::memcmp(slotMap, other.slotMap, sizeof(slotMap)) == 0 &&
+            characters == other.characters &&
+            width_px == other.width_px &&
+            height_px == other.height_px &&
+            horiBearingX_px == other.horiBearingX_px &&
+            horiBearingY_px == other.horiBearingY_px &&
+            horiAdvance_px == other.horiAdvance_px &&
+            vertBearingX_px == other.vertBearingX_px &&
+            vertBearingY_px == other.vertBearingY_px &&
+            vertAdvance_px == other.vertAdvance_px &&
+            textureLeft == other.textureLeft &&
+            textureRight == other.textureRight &&
+            textureBottom == other.textureBottom &&
+            textureTop == other.textureTop;
+    }
+
+    inline bool CompactFontData::operator!=(const CompactFontData& other) const
+    {
+        return !(*this == other);
+    }
+}
@@ -0,0 +1,223 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#include "CorpusLayout.h"
+
+#include "FontToSpriteSheet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+
+
+namespace ftss
+{
+    // how far down the frequency order the next glyph may come from, more
+    // keeps pairs together, less keeps the hottest glyphs further left
+    static const size_t LOOKAHEAD_GLYPH_COUNT = 8;
+
+    // public ------------------------------------------------------------------
+
+    bool LoadCorpusStatistics(
+        CorpusStatistics& corpusStatistics,
+        const std::vector<std::string>& filePaths)
+    {
+        for (const std::string& filePath : filePaths)
+        {
+            std::ifstream fileStream(filePath, std::ios::binary);
+            if (!fileStream.is_open())
+            {
+                std::cerr << "ERROR: failed to open corpus file: " << filePath << std::endl;
+                return false;
+            }
+
+            bool hasPrevious = false;
+            unsigned char previous = 0;
+            char character;
+            while (fileStream.get(character))
+            {
+                unsigned char c = static_cast<unsigned char>(character);
+                if (c == '\n' || c == '\r')
+                {
+                    hasPrevious = false;
+                    continue;
+                }
+
+                ++corpusStatistics.glyphCounts[c];
+                if (hasPrevious)
+                {
+                    ++corpusStatistics.bigramCounts[static_cast<unsigned short>(previous << 8 | c)];
+                }
+                corpusStatistics.text.push_back(c);
+                previous = c;
+                hasPrevious = true;
+            }
+
+            if (fileStream.bad())
+            {
+                std::cerr << "ERROR: file stream error: " << filePath << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void ComputePackOrder(
+        std::vector<unsigned char>& packOrder,
+        const CorpusStatistics& corpusStatistics,
+        const std::vector<unsigned char>& characterList)
+    {
+        std::vector<unsigned char> sortedCharacters(characterList);
+        std::sort(sortedCharacters.begin(), sortedCharacters.end());
+        sortedCharacters.erase(std::unique(sortedCharacters.begin(), sortedCharacters.end()), sortedCharacters.end());
+
+        std::vector<unsigned char> usedGlyphs;
+        std::vector<unsigned char> unusedGlyphs;
+        for (unsigned char c : sortedCharacters)
+        {
+            if (corpusStatistics.glyphCounts[c] > 0)
+            {
+                usedGlyphs.push_back(c);
+            }
+            else
+            {
+                unusedGlyphs.push_back(c);
+            }
+        }
+
+        // most used first, stable so equal counts stay in character order
+        std::stable_sort(usedGlyphs.begin(), usedGlyphs.end(), [&](unsigned char a, unsigned char b)
+        {
+            return corpusStatistics.glyphCounts[a] > corpusStatistics.glyphCounts[b];
+        });
+
+        packOrder.clear();
+        packOrder.reserve(usedGlyphs.size() + unusedGlyphs.size());
+        while (!usedGlyphs.empty())
+        {
+            size_t next = 0;
+            if (!packOrder.empty())
+            {
+                unsigned char previous = packOrder.back();
+                unsigned long long bestCount = 0;
+                for (size_t i = 0; i < std::min(LOOKAHEAD_GLYPH_COUNT, usedGlyphs.size()); ++i)
+                {
+                    unsigned long long count =
+                        corpusStatistics.GetBigramCount(previous, usedGlyphs[i]) +
+                        corpusStatistics.GetBigramCount(usedGlyphs[i], previous);
+                    if (count > bestCount)
+                    {
+                        bestCount = count;
+                        next = i;
+                    }
+                }
+            }
+
+            packOrder.push_back(usedGlyphs[next]);
+            usedGlyphs.erase(usedGlyphs.begin() + next);
+        }
+        packOrder.insert(packOrder.end(), unusedGlyphs.begin(), unusedGlyphs.end());
+    }
+
+    void EstimateTextureLocality(
+        LocalityEstimate& localityEstimate,
+        const CorpusStatistics& corpusStatistics,
+        const FontData& fontData,
+        unsigned int textureWidth,
+        unsigned int textureHeight)
+    {
+        const unsigned int TILE_SIZE = LocalityEstimate::TILE_SIZE_PX;
+
+        localityEstimate = LocalityEstimate();
+        localityEstimate.textureWidth = textureWidth;
+
+        // the box of every glyph in pixels, empty glyphs aren't sampled
+        struct GlyphBox
+        {
+            unsigned int left;
+            unsigned int top;
+            unsigned int right;
+            unsigned int bottom;
+            unsigned long long useCount;
+        };
+        std::vector<GlyphBox> glyphBoxes(256, GlyphBox{ 0, 0, 0, 0, 0 });
+        for (const auto& pair : fontData.glyphMetricsMap)
+        {
+            const GlyphMetrics& glyphMetrics = pair.second;
+            if (glyphMetrics.width_px == 0 || glyphMetrics.height_px == 0)
+            {
+                continue;
+            }
+
+            GlyphBox& glyphBox = glyphBoxes[pair.first];
+            glyphBox.left = static_cast<unsigned int>(std::lround(std::min(glyphMetrics.textureLeft, glyphMetrics.textureRight) * textureWidth));
+            glyphBox.top = GetTextureTopRow(glyphMetrics.textureBottom, glyphMetrics.textureTop, textureHeight);
+            glyphBox.right = glyphBox.left + glyphMetrics.width_px;
+            glyphBox.bottom = glyphBox.top + glyphMetrics.height_px;
+        }
+
+        // least recently used tile at the back
+        std::vector<unsigned int> cachedTiles;
+        cachedTiles.reserve(LocalityEstimate::CACHE_TILE_COUNT);
+        const unsigned int tileCountX = (textureWidth + TILE_SIZE - 1) / TILE_SIZE;
+
+        for (unsigned char c : corpusStatistics.text)
+        {
+            GlyphBox& glyphBox = glyphBoxes[c];
+            if (glyphBox.right == glyphBox.left)
+            {
+                continue;
+            }
+
+            ++glyphBox.useCount;
+            ++localityEstimate.glyphCount;
+            for (unsigned int tileY = glyphBox.top / TILE_SIZE; tileY <= (glyphBox.bottom - 1) / TILE_SIZE; ++tileY)
+            {
+                for (unsigned int tileX = glyphBox.left / TILE_SIZE; tileX <= (glyphBox.right - 1) / TILE_SIZE; ++tileX)
+                {
+                    unsigned int tile = tileY * tileCountX + tileX;
+                    ++localityEstimate.tileAccessCount;
+
+                    std::vector<unsigned int>::iterator cached = std::find(cachedTiles.begin(), cachedTiles.end(), tile);
+                    if (cached != cachedTiles.end())
+                    {
+                        cachedTiles.erase(cached);
+                    }
+                    else
+                    {
+                        ++localityEstimate.tileMissCount;
+                        if (cachedTiles.size() == LocalityEstimate::CACHE_TILE_COUNT)
+                        {
+                            cachedTiles.pop_back();
+                        }
+                    }
+                    cachedTiles.insert(cachedTiles.begin(), tile);
+                }
+            }
+        }
+
+        // grow the region from the left edge until it holds enough of the glyphs drawn
+        std::sort(glyphBoxes.begin(), glyphBoxes.end(), [](const GlyphBox& a, const GlyphBox& b)
+        {
+            return a.right < b.right;
+        });
+        unsigned long long hotCount = 0;
+        for (const GlyphBox& glyphBox : glyphBoxes)
+        {
+            if (glyphBox.useCount == 0)
+            {
+                continue;
+            }
+            if (static_cast<double>(hotCount) >= LocalityEstimate::HOT_SHARE * static_cast<double>(localityEstimate.glyphCount))
+            {
+                break;
+            }
+            hotCount += glyphBox.useCount;
+            localityEstimate.hotWidth_px = glyphBox.right;
+        }
+    }
+}
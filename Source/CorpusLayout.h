@@ -0,0 +1,102 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include "FontData.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // How often every character and every pair of neighbouring characters
+    // shows up in a text corpus, such as the string tables of a game. Every
+    // byte is a character like in the character list. Line breaks split
+    // pairs and aren't counted.
+    struct CorpusStatistics
+    {
+        CorpusStatistics();
+
+        void Clear();
+        unsigned long long GetBigramCount(unsigned char first, unsigned char second) const;
+
+        std::vector<unsigned long long> glyphCounts; // 256 entries
+        std::unordered_map<unsigned short, unsigned long long> bigramCounts; // first << 8 | second
+        std::vector<unsigned char> text; // the corpus itself without line breaks, for EstimateTextureLocality
+    };
+
+    inline CorpusStatistics::CorpusStatistics()
+        : glyphCounts(256, 0)
+    {}
+
+    inline void CorpusStatistics::Clear()
+    {
+        glyphCounts.assign(256, 0);
+        bigramCounts.clear();
+        text.clear();
+    }
+
+    inline unsigned long long CorpusStatistics::GetBigramCount(unsigned char first, unsigned char second) const
+    {
+        auto iter = bigramCounts.find(static_cast<unsigned short>(first << 8 | second));
+        return iter != bigramCounts.end() ? iter->second : 0;
+    }
+
+    // Texture cache behaviour of drawing the corpus text with an atlas. The
+    // texture is cut into TILE_SIZE_PX square tiles and the cache holds the
+    // CACHE_TILE_COUNT tiles used last, every glyph drawn touches the tiles
+    // its box overlaps.
+    struct LocalityEstimate
+    {
+        LocalityEstimate();
+
+        static const unsigned int TILE_SIZE_PX = 32;
+        static const unsigned int CACHE_TILE_COUNT = 16;
+        // the hot region is where this share of all glyphs drawn comes from
+        static constexpr double HOT_SHARE = 0.9;
+
+        unsigned long long glyphCount;
+        unsigned long long tileAccessCount;
+        unsigned long long tileMissCount;
+        // width of the region from the left edge of the texture that holds
+        // the glyphs of HOT_SHARE of the corpus
+        unsigned int hotWidth_px;
+        unsigned int textureWidth;
+    };
+
+    inline LocalityEstimate::LocalityEstimate()
+        : glyphCount(0)
+        , tileAccessCount(0)
+        , tileMissCount(0)
+        , hotWidth_px(0)
+        , textureWidth(0)
+    {}
+
+    // Adds the characters of every file to corpusStatistics
+    bool LoadCorpusStatistics(
+        CorpusStatistics& corpusStatistics,
+        const std::vector<std::string>& filePaths);
+
+    // Order to pack the glyphs of characterList in. The most used glyphs come
+    // first so they end up in the first tiles of the texture. Among the 8
+    // most used glyphs left the next one is the glyph that most often
+    // neighbours the one before it in the corpus. Glyphs the corpus doesn't
+    // use follow in character order.
+    void ComputePackOrder(
+        std::vector<unsigned char>& packOrder,
+        const CorpusStatistics& corpusStatistics,
+        const std::vector<unsigned char>& characterList);
+
+    // Replays the corpus text against the texture coordinates of fontData
+    void EstimateTextureLocality(
+        LocalityEstimate& localityEstimate,
+        const CorpusStatistics& corpusStatistics,
+        const FontData& fontData,
+        unsigned int textureWidth,
+        unsigned int textureHeight);
+}
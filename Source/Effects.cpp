@@ -0,0 +1,269 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#include "Effects.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+
+namespace ftss
+{
+#if defined(FTSS_X86)
+    static const bool s_hasAvx2 = HasAvx2_H();
+
+    FTSS_TARGET_AVX2 static unsigned int DilateRowAvx2_H(
+        unsigned char* destination,
+        const unsigned char* source,
+        unsigned int width,
+        unsigned int firstRow,
+        unsigned int lastRow)
+    {
+        unsigned int i = 0;
+        for (; i + 32 <= width; i += 32)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + static_cast<size_t>(firstRow) * width + i));
+            for (unsigned int row = firstRow + 1; row <= lastRow; ++row)
+            {
+                x = _mm256_max_epu8(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + static_cast<size_t>(row) * width + i)));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), x);
+        }
+        return i;
+    }
+
+    static unsigned int DilateRowSse2_H(
+        unsigned char* destination,
+        const unsigned char* source,
+        unsigned int width,
+        unsigned int firstRow,
+        unsigned int lastRow)
+    {
+        unsigned int i = 0;
+        for (; i + 16 <= width; i += 16)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + static_cast<size_t>(firstRow) * width + i));
+            for (unsigned int row = firstRow + 1; row <= lastRow; ++row)
+            {
+                x = _mm_max_epu8(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + static_cast<size_t>(row) * width + i)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), x);
+        }
+        return i;
+    }
+
+    // the weights are added in the same order as in the scalar loop and
+    // without fused multiply adds, so every path gives the same floats
+    FTSS_TARGET_AVX2 static unsigned int BlurRowAvx2_H(
+        float* destination,
+        const float* source,
+        unsigned int width,
+        const float* weights,
+        unsigned int firstRow,
+        unsigned int lastRow)
+    {
+        unsigned int i = 0;
+        for (; i + 8 <= width; i += 8)
+        {
+            __m256 x = _mm256_setzero_ps();
+            for (unsigned int row = firstRow; row <= lastRow; ++row)
+            {
+                __m256 weight = _mm256_set1_ps(weights[row - firstRow]);
+                x = _mm256_add_ps(x, _mm256_mul_ps(weight, _mm256_loadu_ps(source + static_cast<size_t>(row) * width + i)));
+            }
+            _mm256_storeu_ps(destination + i, x);
+        }
+        return i;
+    }
+
+    static unsigned int BlurRowSse2_H(
+        float* destination,
+        const float* source,
+        unsigned int width,
+        const float* weights,
+        unsigned int firstRow,
+        unsigned int lastRow)
+    {
+        unsigned int i = 0;
+        for (; i + 4 <= width; i += 4)
+        {
+            __m128 x = _mm_setzero_ps();
+            for (unsigned int row = firstRow; row <= lastRow; ++row)
+            {
+                __m128 weight = _mm_set1_ps(weights[row - firstRow]);
+                x = _mm_add_ps(x, _mm_mul_ps(weight, _mm_loadu_ps(source + static_cast<size_t>(row) * width + i)));
+            }
+            _mm_storeu_ps(destination + i, x);
+        }
+        return i;
+    }
+#endif
+
+    // rows become columns, the passes only ever work down columns where
+    // neighbouring pixels sit next to each other in memory
+    template <typename T>
+    static void Transpose_H(
+        T* destination,
+        const T* source,
+        unsigned int width,
+        unsigned int height)
+    {
+        for (unsigned int j = 0; j < height; ++j)
+        {
+            for (unsigned int i = 0; i < width; ++i)
+            {
+                destination[static_cast<size_t>(i) * height + j] = source[static_cast<size_t>(j) * width + i];
+            }
+        }
+    }
+
+    // public ------------------------------------------------------------------
+
+    void DilateCoverage(
+        std::vector<unsigned char>& coverage,
+        std::vector<unsigned char>& scratch,
+        unsigned int width,
+        unsigned int height,
+        unsigned int radius)
+    {
+        if (radius == 0 || width == 0 || height == 0)
+        {
+            return;
+        }
+
+        scratch.resize(static_cast<size_t>(width) * height);
+
+        DilateColumns_H(scratch.data(), coverage.data(), width, height, radius);
+        Transpose_H(coverage.data(), scratch.data(), width, height);
+        DilateColumns_H(scratch.data(), coverage.data(), height, width, radius);
+        Transpose_H(coverage.data(), scratch.data(), height, width);
+    }
+
+    void BlurCoverage(
+        std::vector<unsigned char>& coverage,
+        std::vector<float>& scratch,
+        unsigned int width,
+        unsigned int height,
+        unsigned int radius)
+    {
+        if (radius == 0 || width == 0 || height == 0)
+        {
+            return;
+        }
+
+        std::vector<float> weights(2 * radius + 1);
+        float sigma = 0.5f * static_cast<float>(radius);
+        float sum = 0.0f;
+        for (unsigned int k = 0; k < weights.size(); ++k)
+        {
+            float x = static_cast<float>(static_cast<int>(k) - static_cast<int>(radius));
+            weights[k] = std::exp(-x * x / (2.0f * sigma * sigma));
+            sum += weights[k];
+        }
+        for (float& weight : weights)
+        {
+            weight /= sum;
+        }
+
+        size_t size = static_cast<size_t>(width) * height;
+        scratch.resize(size * 2);
+        float* values = scratch.data();
+        float* blurred = scratch.data() + size;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            values[i] = static_cast<float>(coverage[i]);
+        }
+
+        BlurColumns_H(blurred, values, width, height, weights.data(), radius);
+        Transpose_H(values, blurred, width, height);
+        BlurColumns_H(blurred, values, height, width, weights.data(), radius);
+        Transpose_H(values, blurred, height, width);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            coverage[i] = static_cast<unsigned char>(std::lrint(std::min(values[i], 255.0f)));
+        }
+    }
+
+    // protected ---------------------------------------------------------------
+
+    void DilateColumns_H(
+        unsigned char* destination,
+        const unsigned char* source,
+        unsigned int width,
+        unsigned int height,
+        unsigned int radius)
+    {
+        for (unsigned int j = 0; j < height; ++j)
+        {
+            unsigned int firstRow = j > radius ? j - radius : 0;
+            unsigned int lastRow = std::min(j + radius, height - 1);
+            unsigned char* row = destination + static_cast<size_t>(j) * width;
+
+            unsigned int i = 0;
+#if defined(FTSS_X86)
+            if (s_hasAvx2)
+            {
+                i = DilateRowAvx2_H(row, source, width, firstRow, lastRow);
+            }
+            else
+            {
+                i = DilateRowSse2_H(row, source, width, firstRow, lastRow);
+            }
+#endif
+            for (; i < width; ++i)
+            {
+                unsigned char x = source[static_cast<size_t>(firstRow) * width + i];
+                for (unsigned int k = firstRow + 1; k <= lastRow; ++k)
+                {
+                    x = std::max(x, source[static_cast<size_t>(k) * width + i]);
+                }
+                row[i] = x;
+            }
+        }
+    }
+
+    void BlurColumns_H(
+        float* destination,
+        const float* source,
+        unsigned int width,
+        unsigned int height,
+        const float* weights,
+        unsigned int radius)
+    {
+        for (unsigned int j = 0; j < height; ++j)
+        {
+            // rows outside the bitmap are 0 and left out of the sum
+            unsigned int firstRow = j > radius ? j - radius : 0;
+            unsigned int lastRow = std::min(j + radius, height - 1);
+            const float* rowWeights = weights + (firstRow + radius - j);
+            float* row = destination + static_cast<size_t>(j) * width;
+
+            unsigned int i = 0;
+#if defined(FTSS_X86)
+            if (s_hasAvx2)
+            {
+                i = BlurRowAvx2_H(row, source, width, rowWeights, firstRow, lastRow);
+            }
+            else
+            {
+                i = BlurRowSse2_H(row, source, width, rowWeights, firstRow, lastRow);
+            }
+#endif
+            for (; i < width; ++i)
+            {
+                float x = 0.0f;
+                for (unsigned int k = firstRow; k <= lastRow; ++k)
+                {
+                    x += rowWeights[k - firstRow] * source[static_cast<size_t>(k) * width + i];
+                }
+                row[i] = x;
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include <vector>
+
+
+
+namespace ftss
+{
+    // Effect layers baked next to the glyphs, each into its own channel of
+    // the texture with the same texture coordinates as the glyph. A radius
+    // of 0 leaves the effect out and its channel empty, a shadow with an
+    // offset is still there but hard. The glyph stays in the alpha channel.
+    struct EffectSettings
+    {
+        EffectSettings();
+
+        static const unsigned char OUTLINE_CHANNEL = 0;
+        static const unsigned char GLOW_CHANNEL = 1;
+        static const unsigned char SHADOW_CHANNEL = 2;
+        static const unsigned int MAX_RADIUS_PX = 64;
+
+        bool IsEmpty() const;
+        bool HasShadow() const;
+        // Pixels every glyph box grows by on each side to fit the effects
+        unsigned int GetPadding() const;
+
+        // glyph stroked on its outside with FreeType
+        unsigned int outlineRadius_px;
+        // glyph dilated by half the radius and blurred by the other half
+        unsigned int glowRadius_px;
+        // glyph blurred by the radius and moved by the offset, y points down
+        unsigned int shadowRadius_px;
+        int shadowOffsetX_px;
+        int shadowOffsetY_px;
+    };
+
+    inline EffectSettings::EffectSettings()
+        : outlineRadius_px(0)
+        , glowRadius_px(0)
+        , shadowRadius_px(0)
+        , shadowOffsetX_px(0)
+        , shadowOffsetY_px(0)
+    {}
+
+    inline bool EffectSettings::IsEmpty() const
+    {
+        return outlineRadius_px == 0 && glowRadius_px == 0 && !HasShadow();
+    }
+
+    inline bool EffectSettings::HasShadow() const
+    {
+        return shadowRadius_px != 0 || shadowOffsetX_px != 0 || shadowOffsetY_px != 0;
+    }
+
+    inline unsigned int EffectSettings::GetPadding() const
+    {
+        // the stroke can reach one pixel past its radius once it's rounded to pixels
+        unsigned int padding = outlineRadius_px > 0 ? outlineRadius_px + 1 : 0;
+        if (glowRadius_px > padding)
+        {
+            padding = glowRadius_px;
+        }
+
+        unsigned int shadowOffsetX = static_cast<unsigned int>(shadowOffsetX_px < 0 ? -shadowOffsetX_px : shadowOffsetX_px);
+        unsigned int shadowOffsetY = static_cast<unsigned int>(shadowOffsetY_px < 0 ? -shadowOffsetY_px : shadowOffsetY_px);
+        unsigned int shadowPadding = shadowRadius_px + (shadowOffsetX > shadowOffsetY ? shadowOffsetX : shadowOffsetY);
+        if (shadowPadding > padding)
+        {
+            padding = shadowPadding;
+        }
+
+        return padding;
+    }
+
+    // Grows the coverage of a width * height bitmap by radius pixels in
+    // every direction, a maximum over a square done as two 1D passes.
+    // The passes use AVX2 or SSE2 when the processor has them.
+    void DilateCoverage(
+        std::vector<unsigned char>& coverage,
+        std::vector<unsigned char>& scratch,
+        unsigned int width,
+        unsigned int height,
+        unsigned int radius);
+
+    // Gaussian blur of a width * height bitmap with a kernel reaching
+    // radius pixels (sigma is half the radius), done as two 1D passes.
+    // Pixels outside the bitmap count as 0. The passes use AVX2 or SSE2
+    // when the processor has them and give the same result either way.
+    void BlurCoverage(
+        std::vector<unsigned char>& coverage,
+        std::vector<float>& scratch,
+        unsigned int width,
+        unsigned int height,
+        unsigned int radius);
+
+    // Used in DilateCoverage, maximum over rows y - radius to y + radius
+    void DilateColumns_H(
+        unsigned char* destination,
+        const unsigned char* source,
+        unsigned int width,
+        unsigned int height,
+        unsigned int radius);
+
+    // Used in BlurCoverage, weighted sum over rows y - radius to y + radius
+    void BlurColumns_H(
+        float* destination,
+        const float* source,
+        unsigned int width,
+        unsigned int height,
+        const float* weights,
+        unsigned int radius);
+}
@@ -0,0 +1,151 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace ftss
+{
+    // public ------------------------------------------------------------------
+
+    FileWatcher::FileWatcher()
+        : m_fileDescriptor(-1)
+    {
+#if defined(__linux__)
+        m_fileDescriptor = inotify_init1(IN_CLOEXEC);
+#endif
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+#if defined(__linux__)
+        if (m_fileDescriptor >= 0)
+        {
+            close(m_fileDescriptor);
+        }
+#endif
+    }
+
+    bool FileWatcher::AddFile(const std::string& filePath)
+    {
+#if defined(__linux__)
+        if (m_fileDescriptor < 0)
+        {
+            std::cerr << "ERROR: could not initialize inotify" << std::endl;
+            return false;
+        }
+
+        std::error_code errorCode;
+        std::filesystem::path absolutePath = std::filesystem::absolute(filePath, errorCode);
+        if (errorCode)
+        {
+            std::cerr << "ERROR: invalid file path: " << filePath << std::endl;
+            return false;
+        }
+
+        WatchedFile watchedFile;
+        watchedFile.filePath = filePath;
+        watchedFile.directoryPath = absolutePath.parent_path().string();
+        watchedFile.fileName = absolutePath.filename().string();
+
+        int watchDescriptor = inotify_add_watch(
+            m_fileDescriptor,
+            watchedFile.directoryPath.c_str(),
+            IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watchDescriptor < 0)
+        {
+            std::cerr << "ERROR: could not watch directory: " << watchedFile.directoryPath << std::endl;
+            return false;
+        }
+
+        m_watchDescriptorMap[watchDescriptor] = watchedFile.directoryPath;
+        m_watchedFiles.push_back(watchedFile);
+        return true;
+#else
+        (void)filePath;
+        std::cerr << "ERROR: watching files is not supported on this platform" << std::endl;
+        return false;
+#endif
+    }
+
+    bool FileWatcher::WaitForChanges(
+        std::vector<std::string>& changedFiles,
+        unsigned int debounceMilliseconds)
+    {
+        changedFiles.clear();
+#if defined(__linux__)
+        if (m_fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+        int timeout = -1; // wait for the first change as long as it takes
+        while (true)
+        {
+            pollfd pollFileDescriptor = { m_fileDescriptor, POLLIN, 0 };
+            int pollResult = poll(&pollFileDescriptor, 1, timeout);
+            if (pollResult < 0)
+            {
+                std::cerr << "ERROR: waiting for file changes failed" << std::endl;
+                return false;
+            }
+            if (pollResult == 0)
+            {
+                // quiet for the whole debounce time
+                return true;
+            }
+
+            ssize_t length = read(m_fileDescriptor, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                std::cerr << "ERROR: reading file changes failed" << std::endl;
+                return false;
+            }
+
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+                if (event->len == 0)
+                {
+                    continue;
+                }
+
+                const std::string& directoryPath = m_watchDescriptorMap[event->wd];
+                for (const WatchedFile& watchedFile : m_watchedFiles)
+                {
+                    if (watchedFile.directoryPath == directoryPath &&
+                        watchedFile.fileName == event->name &&
+                        std::find(changedFiles.begin(), changedFiles.end(), watchedFile.filePath) == changedFiles.end())
+                    {
+                        changedFiles.push_back(watchedFile.filePath);
+                    }
+                }
+            }
+
+            // changes to other files in the directories don't start the debounce
+            if (!changedFiles.empty())
+            {
+                timeout = static_cast<int>(debounceMilliseconds);
+            }
+        }
+#else
+        (void)debounceMilliseconds;
+        std::cerr << "ERROR: watching files is not supported on this platform" << std::endl;
+        return false;
+#endif
+    }
+}
@@ -0,0 +1,48 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // Reports when files are written, replaced or moved into place. The
+    // directories are watched rather than the files, editors often save by
+    // renaming a new file over the old one. Only implemented with inotify
+    // on Linux, elsewhere AddFile fails.
+    struct FileWatcher
+    {
+        FileWatcher();
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        bool AddFile(const std::string& filePath);
+
+        // Blocks until a watched file changes and then until no change came
+        // in for debounceMilliseconds, so a burst of saves is one change.
+        // changedFiles gets the paths as they were passed to AddFile.
+        bool WaitForChanges(
+            std::vector<std::string>& changedFiles,
+            unsigned int debounceMilliseconds = 250);
+
+    private:
+        struct WatchedFile
+        {
+            std::string filePath;
+            std::string directoryPath;
+            std::string fileName;
+        };
+
+        int m_fileDescriptor;
+        std::unordered_map<int, std::string> m_watchDescriptorMap;
+        std::vector<WatchedFile> m_watchedFiles;
+    };
+}
@@ -0,0 +1,648 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#include "FontBundle.h"
+
+#include "FontToSpriteSheet.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace ftss
+{
+    static const size_t SLOT_MAP_SIZE = 256 * sizeof(unsigned short);
+
+    static size_t AlignOffset_H(size_t offset)
+    {
+        return (offset + FONT_BUNDLE_ALIGNMENT - 1) / FONT_BUNDLE_ALIGNMENT * FONT_BUNDLE_ALIGNMENT;
+    }
+
+    static size_t GetFontTableSize_H(unsigned int glyphCount, unsigned int subpixelVariantCount)
+    {
+        return SLOT_MAP_SIZE +
+            static_cast<size_t>(glyphCount) * sizeof(FontBundleGlyph) +
+            static_cast<size_t>(glyphCount) * (subpixelVariantCount - 1) * sizeof(FontBundleSubpixelVariant);
+    }
+
+    // public ------------------------------------------------------------------
+
+    FontBundle::FontBundle()
+        : m_data(nullptr)
+        , m_size(0)
+        , m_mapped(false)
+        , m_header(nullptr)
+        , m_directory(nullptr)
+    {}
+
+    FontBundle::~FontBundle()
+    {
+        Close();
+    }
+
+    FontBundle::FontBundle(FontBundle&& other) noexcept
+        : m_data(other.m_data)
+        , m_size(other.m_size)
+        , m_mapped(other.m_mapped)
+        , m_header(other.m_header)
+        , m_directory(other.m_directory)
+        , m_fontSlots(std::move(other.m_fontSlots))
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_mapped = false;
+        other.m_header = nullptr;
+        other.m_directory = nullptr;
+    }
+
+    FontBundle& FontBundle::operator=(FontBundle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_mapped = other.m_mapped;
+            m_header = other.m_header;
+            m_directory = other.m_directory;
+            m_fontSlots = std::move(other.m_fontSlots);
+
+            other.m_data = nullptr;
+            other.m_size = 0;
+            other.m_mapped = false;
+            other.m_header = nullptr;
+            other.m_directory = nullptr;
+        }
+        return *this;
+    }
+
+    bool FontBundle::Open(const std::string& filePath)
+    {
+        Close();
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            std::cerr << "ERROR: failed to open file" << std::endl;
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            std::cerr << "ERROR: invalid font bundle size" << std::endl;
+            CloseHandle(file);
+            return false;
+        }
+
+        // the view keeps the mapping alive, neither handle is needed after it
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mapping != nullptr)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        if (data == nullptr)
+        {
+            std::cerr << "ERROR: failed to map the font bundle" << std::endl;
+            return false;
+        }
+
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fileDescriptor = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0)
+        {
+            std::cerr << "ERROR: failed to open file" << std::endl;
+            return false;
+        }
+
+        struct stat fileStatus;
+        if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size <= 0)
+        {
+            std::cerr << "ERROR: invalid font bundle size" << std::endl;
+            close(fileDescriptor);
+            return false;
+        }
+
+        // the mapping stays valid after the file is closed
+        void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        close(fileDescriptor);
+        if (data == MAP_FAILED)
+        {
+            std::cerr << "ERROR: failed to map the font bundle" << std::endl;
+            return false;
+        }
+
+        m_size = static_cast<size_t>(fileStatus.st_size);
+#endif
+
+        m_data = static_cast<const unsigned char*>(data);
+        m_mapped = true;
+
+        if (!ValidateDirectory_H())
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool FontBundle::Open(const unsigned char* dataPtr, size_t dataSize)
+    {
+        Close();
+
+        if (dataPtr == nullptr || reinterpret_cast<size_t>(dataPtr) % 8 != 0)
+        {
+            std::cerr << "ERROR: the font bundle must be aligned to 8 bytes" << std::endl;
+            return false;
+        }
+
+        m_data = dataPtr;
+        m_size = dataSize;
+        m_mapped = false;
+
+        if (!ValidateDirectory_H())
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void FontBundle::Close()
+    {
+        if (m_mapped && m_data != nullptr)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+#else
+            munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_mapped = false;
+        m_header = nullptr;
+        m_directory = nullptr;
+        m_fontSlots.clear();
+    }
+
+    bool FontBundle::IsOpen() const
+    {
+        return m_data != nullptr;
+    }
+
+    unsigned int FontBundle::GetFontCount() const
+    {
+        return static_cast<unsigned int>(m_fontSlots.size());
+    }
+
+    bool FontBundle::GetFont(FontBundleView& fontBundleView, unsigned int index) const
+    {
+        if (index >= m_fontSlots.size())
+        {
+            return false;
+        }
+
+        SetView_H(fontBundleView, m_directory[m_fontSlots[index]]);
+        return true;
+    }
+
+    bool FontBundle::FindFont(FontBundleView& fontBundleView, const std::string& fontName, unsigned int fontSize_px) const
+    {
+        if (!IsOpen() || fontSize_px == 0)
+        {
+            return false;
+        }
+
+        const unsigned long long keyHash = GetFontBundleKeyHash(fontName.data(), fontName.size(), fontSize_px);
+        const unsigned int slotMask = m_header->slotCount - 1;
+        for (unsigned int i = 0; i < m_header->slotCount; ++i)
+        {
+            const FontBundleEntry& entry = m_directory[(keyHash + i) & slotMask];
+            if (entry.fontSize_px == 0)
+            {
+                return false;
+            }
+
+            if (entry.keyHash == keyHash &&
+                entry.fontSize_px == fontSize_px &&
+                entry.nameLength == fontName.size() &&
+                std::memcmp(m_data + entry.nameOffset, fontName.data(), fontName.size()) == 0)
+            {
+                SetView_H(fontBundleView, entry);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    unsigned long long GetFontBundleKeyHash(
+        const char* fontName,
+        size_t nameLength,
+        unsigned int fontSize_px)
+    {
+        unsigned long long hash = 14695981039346656037ull;
+        for (size_t i = 0; i < nameLength; ++i)
+        {
+            hash ^= static_cast<unsigned char>(fontName[i]);
+            hash *= 1099511628211ull;
+        }
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            hash ^= (fontSize_px >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool EncodeFontBundle(
+        std::vector<unsigned char>& buffer,
+        const std::vector<FontBundleSource>& fontBundleSources)
+    {
+        if (fontBundleSources.empty())
+        {
+            std::cerr << "ERROR: a font bundle needs at least one font" << std::endl;
+            return false;
+        }
+
+        unsigned int slotCount = 1;
+        while (slotCount < fontBundleSources.size() * 2)
+        {
+            slotCount <<= 1;
+        }
+
+        // lay out everything first, the metrics of all fonts come before the
+        // textures so opening every font touches as few pages as possible
+        std::vector<FontBundleEntry> directory(slotCount, FontBundleEntry());
+        std::vector<size_t> slotSources(slotCount, 0); // index into fontBundleSources of every used slot
+
+        size_t offset = sizeof(FontBundleHeader) + static_cast<size_t>(slotCount) * sizeof(FontBundleEntry);
+        std::vector<size_t> nameOffsets(fontBundleSources.size());
+        for (size_t i = 0; i < fontBundleSources.size(); ++i)
+        {
+            nameOffsets[i] = offset;
+            offset += fontBundleSources[i].fontName.size() + 1;
+        }
+
+        std::vector<size_t> fontTableOffsets(fontBundleSources.size());
+        for (size_t i = 0; i < fontBundleSources.size(); ++i)
+        {
+            const FontBundleSource& source = fontBundleSources[i];
+            if (source.fontName.empty() || source.fontSize_px == 0)
+            {
+                std::cerr << "ERROR: every font in a bundle needs a name and a size" << std::endl;
+                return false;
+            }
+            if (source.fontData.glyphMetricsMap.size() > 256 ||
+                source.fontData.subpixelVariantCount < 1 ||
+                source.fontData.subpixelVariantCount > FontData::MAX_SUBPIXEL_VARIANT_COUNT)
+            {
+                std::cerr << "ERROR: invalid font data for " << source.fontName << " " << source.fontSize_px << " px" << std::endl;
+                return false;
+            }
+
+            offset = AlignOffset_H(offset);
+            fontTableOffsets[i] = offset;
+            offset += GetFontTableSize_H(static_cast<unsigned int>(source.fontData.glyphMetricsMap.size()), source.fontData.subpixelVariantCount);
+        }
+
+        std::vector<size_t> textureOffsets(fontBundleSources.size(), 0);
+        for (size_t i = 0; i < fontBundleSources.size(); ++i)
+        {
+            const TextureData& textureData = fontBundleSources[i].textureData;
+            if (textureData.data != nullptr && textureData.GetSize() != 0)
+            {
+                offset = AlignOffset_H(offset);
+                textureOffsets[i] = offset;
+                offset += textureData.GetSize();
+            }
+        }
+        const size_t fileSize = offset;
+
+        for (size_t i = 0; i < fontBundleSources.size(); ++i)
+        {
+            const FontBundleSource& source = fontBundleSources[i];
+
+            FontBundleEntry entry = FontBundleEntry();
+            entry.keyHash = GetFontBundleKeyHash(source.fontName.data(), source.fontName.size(), source.fontSize_px);
+            entry.nameOffset = nameOffsets[i];
+            entry.fontTableOffset = fontTableOffsets[i];
+            entry.textureOffset = textureOffsets[i];
+            entry.fontSize_px = source.fontSize_px;
+            entry.nameLength = static_cast<unsigned int>(source.fontName.size());
+            entry.lineSpacing_px = source.fontData.lineSpacing_px;
+            entry.glyphCount = static_cast<unsigned int>(source.fontData.glyphMetricsMap.size());
+            entry.subpixelVariantCount = source.fontData.subpixelVariantCount;
+            if (textureOffsets[i] != 0)
+            {
+                entry.textureWidth = source.textureData.width;
+                entry.textureHeight = source.textureData.height;
+                entry.bytesPerPixel = source.textureData.bytesPerPixel;
+            }
+
+            // linear probing, the table is at most half full
+            unsigned int slot = static_cast<unsigned int>(entry.keyHash & (slotCount - 1));
+            while (directory[slot].fontSize_px != 0)
+            {
+                if (directory[slot].fontSize_px == entry.fontSize_px &&
+                    fontBundleSources[slotSources[slot]].fontName == source.fontName)
+                {
+                    std::cerr << "ERROR: " << source.fontName << " " << source.fontSize_px << " px is in the bundle twice" << std::endl;
+                    return false;
+                }
+                slot = (slot + 1) & (slotCount - 1);
+            }
+            directory[slot] = entry;
+            slotSources[slot] = i;
+        }
+
+        const size_t start = buffer.size();
+        buffer.resize(start + fileSize, 0);
+        unsigned char* bundle = buffer.data() + start;
+
+        FontBundleHeader header = FontBundleHeader();
+        std::memcpy(header.signature, "FSSBNDL", 8);
+        header.version = FontBundleHeader::VERSION;
+        header.fontCount = static_cast<unsigned int>(fontBundleSources.size());
+        header.slotCount = slotCount;
+        header.directoryOffset = sizeof(FontBundleHeader);
+        header.fileSize = fileSize;
+        std::memcpy(bundle, &header, sizeof(header)); // ------------------------------- 64 bytes
+        std::memcpy(bundle + header.directoryOffset, directory.data(), slotCount * sizeof(FontBundleEntry)); // 64 bytes each
+
+        for (size_t i = 0; i < fontBundleSources.size(); ++i)
+        {
+            const FontBundleSource& source = fontBundleSources[i];
+            std::memcpy(bundle + nameOffsets[i], source.fontName.data(), source.fontName.size()); // the 0 is already there
+
+            // the glyphs in character order, so the same fonts always give the same bundle
+            std::vector<unsigned char> characters;
+            characters.reserve(source.fontData.glyphMetricsMap.size());
+            for (const auto& pair : source.fontData.glyphMetricsMap)
+            {
+                characters.push_back(pair.first);
+            }
+            std::sort(characters.begin(), characters.end());
+
+            unsigned short slotMap[256];
+            for (unsigned int c = 0; c < 256; ++c)
+            {
+                slotMap[c] = FontBundleGlyph::INVALID_SLOT;
+            }
+
+            unsigned char* glyphPtr = bundle + fontTableOffsets[i] + SLOT_MAP_SIZE;
+            unsigned char* variantPtr = glyphPtr + characters.size() * sizeof(FontBundleGlyph);
+            for (size_t slot = 0; slot < characters.size(); ++slot)
+            {
+                const unsigned char character = characters[slot];
+                const GlyphMetrics& metrics = source.fontData.glyphMetricsMap.at(character);
+                slotMap[character] = static_cast<unsigned short>(slot);
+
+                FontBundleGlyph glyph = FontBundleGlyph();
+                glyph.character = character;
+                glyph.channel = metrics.channel;
+                glyph.width_px = metrics.width_px;
+                glyph.height_px = metrics.height_px;
+                glyph.horiBearingX_px = metrics.horiBearingX_px;
+                glyph.horiBearingY_px = metrics.horiBearingY_px;
+                glyph.horiAdvance_px = metrics.horiAdvance_px;
+                glyph.vertBearingX_px = metrics.vertBearingX_px;
+                glyph.vertBearingY_px = metrics.vertBearingY_px;
+                glyph.vertAdvance_px = metrics.vertAdvance_px;
+                glyph.textureLeft = metrics.textureLeft;
+                glyph.textureRight = metrics.textureRight;
+                glyph.textureBottom = metrics.textureBottom;
+                glyph.textureTop = metrics.textureTop;
+                std::memcpy(glyphPtr, &glyph, sizeof(glyph)); // ----------------------- 52 bytes
+                glyphPtr += sizeof(glyph);
+
+                // a glyph without variants gets empty ones, the count is per font
+                auto variants = source.fontData.subpixelVariantMap.find(character);
+                for (unsigned int v = 0; v < source.fontData.subpixelVariantCount - 1; ++v)
+                {
+                    FontBundleSubpixelVariant variant = FontBundleSubpixelVariant();
+                    if (variants != source.fontData.subpixelVariantMap.end() && v < variants->second.size())
+                    {
+                        const SubpixelVariant& subpixelVariant = variants->second[v];
+                        variant.width_px = subpixelVariant.width_px;
+                        variant.horiBearingX_px = subpixelVariant.horiBearingX_px;
+                        variant.textureLeft = subpixelVariant.textureLeft;
+                        variant.textureRight = subpixelVariant.textureRight;
+                        variant.textureBottom = subpixelVariant.textureBottom;
+                        variant.textureTop = subpixelVariant.textureTop;
+                    }
+                    std::memcpy(variantPtr, &variant, sizeof(variant)); // ------------- 24 bytes
+                    variantPtr += sizeof(variant);
+                }
+            }
+            std::memcpy(bundle + fontTableOffsets[i], slotMap, SLOT_MAP_SIZE); // ------ 512 bytes
+
+            if (textureOffsets[i] != 0)
+            {
+                std::memcpy(bundle + textureOffsets[i], source.textureData.data, source.textureData.GetSize()); // width * height * bytesPerPixel bytes
+            }
+        }
+
+        return true;
+    }
+
+    bool WriteFontBundle(
+        const std::vector<FontBundleSource>& fontBundleSources,
+        const std::string& filePath)
+    {
+        std::vector<unsigned char> buffer;
+        if (!EncodeFontBundle(buffer, fontBundleSources))
+        {
+            return false;
+        }
+        return WriteFile_H(buffer.data(), buffer.size(), filePath);
+    }
+
+    void ConvertFromFontBundleView(
+        FontData& fontData,
+        const FontBundleView& fontBundleView)
+    {
+        fontData.Clear();
+        fontData.lineSpacing_px = fontBundleView.lineSpacing_px;
+        fontData.subpixelVariantCount = fontBundleView.subpixelVariantCount;
+
+        for (unsigned int slot = 0; slot < fontBundleView.glyphCount; ++slot)
+        {
+            const FontBundleGlyph& glyph = fontBundleView.glyphs[slot];
+
+            GlyphMetrics& metrics = fontData.glyphMetricsMap[glyph.character];
+            metrics.width_px = glyph.width_px;
+            metrics.height_px = glyph.height_px;
+            metrics.horiBearingX_px = glyph.horiBearingX_px;
+            metrics.horiBearingY_px = glyph.horiBearingY_px;
+            metrics.horiAdvance_px = glyph.horiAdvance_px;
+            metrics.vertBearingX_px = glyph.vertBearingX_px;
+            metrics.vertBearingY_px = glyph.vertBearingY_px;
+            metrics.vertAdvance_px = glyph.vertAdvance_px;
+            metrics.textureLeft = glyph.textureLeft;
+            metrics.textureRight = glyph.textureRight;
+            metrics.textureBottom = glyph.textureBottom;
+            metrics.textureTop = glyph.textureTop;
+            metrics.channel = glyph.channel;
+
+            if (fontBundleView.subpixelVariantCount > 1)
+            {
+                const FontBundleSubpixelVariant* variants =
+                    fontBundleView.subpixelVariants + static_cast<size_t>(slot) * (fontBundleView.subpixelVariantCount - 1);
+                std::vector<SubpixelVariant>& subpixelVariants = fontData.subpixelVariantMap[glyph.character];
+                subpixelVariants.resize(fontBundleView.subpixelVariantCount - 1);
+                for (unsigned int v = 0; v < fontBundleView.subpixelVariantCount - 1; ++v)
+                {
+                    const FontBundleSubpixelVariant& variant = variants[v];
+                    SubpixelVariant& subpixelVariant = subpixelVariants[v];
+                    subpixelVariant.width_px = variant.width_px;
+                    subpixelVariant.horiBearingX_px = variant.horiBearingX_px;
+                    subpixelVariant.textureLeft = variant.textureLeft;
+                    subpixelVariant.textureRight = variant.textureRight;
+                    subpixelVariant.textureBottom = variant.textureBottom;
+                    subpixelVariant.textureTop = variant.textureTop;
+                }
+            }
+        }
+    }
+
+    // protected ---------------------------------------------------------------
+
+    bool FontBundle::ValidateDirectory_H()
+    {
+        // only the header and directory are read here, the font tables and
+        // textures are left alone until a view of them is used
+        if (m_size < sizeof(FontBundleHeader) || std::memcmp(m_data, "FSSBNDL", 8) != 0)
+        {
+            std::cerr << "ERROR: invalid font bundle signature" << std::endl;
+            return false;
+        }
+
+        m_header = reinterpret_cast<const FontBundleHeader*>(m_data);
+        if (m_header->version != FontBundleHeader::VERSION)
+        {
+            std::cerr << "ERROR: unsupported version" << std::endl;
+            return false;
+        }
+
+        if (m_header->fileSize < sizeof(FontBundleHeader) || m_header->fileSize > m_size)
+        {
+            std::cerr << "ERROR: unexpected end of font bundle" << std::endl;
+            return false;
+        }
+
+        // anything after the bundle isn't part of it
+        const size_t bundleSize = static_cast<size_t>(m_header->fileSize);
+
+        const unsigned int slotCount = m_header->slotCount;
+        if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0 ||
+            m_header->directoryOffset < sizeof(FontBundleHeader) || m_header->directoryOffset % 8 != 0 ||
+            m_header->directoryOffset > bundleSize ||
+            (bundleSize - m_header->directoryOffset) / sizeof(FontBundleEntry) < slotCount)
+        {
+            std::cerr << "ERROR: invalid font bundle directory" << std::endl;
+            return false;
+        }
+        m_directory = reinterpret_cast<const FontBundleEntry*>(m_data + m_header->directoryOffset);
+
+        for (unsigned int slot = 0; slot < slotCount; ++slot)
+        {
+            const FontBundleEntry& entry = m_directory[slot];
+            if (entry.fontSize_px == 0)
+            {
+                continue;
+            }
+
+            bool valid = entry.nameLength != 0 &&
+                entry.nameOffset < bundleSize && entry.nameLength < bundleSize - entry.nameOffset &&
+                m_data[entry.nameOffset + entry.nameLength] == 0 &&
+                entry.glyphCount <= 256 &&
+                entry.subpixelVariantCount >= 1 && entry.subpixelVariantCount <= FontData::MAX_SUBPIXEL_VARIANT_COUNT &&
+                entry.fontTableOffset % FONT_BUNDLE_ALIGNMENT == 0 && entry.fontTableOffset <= bundleSize &&
+                GetFontTableSize_H(entry.glyphCount, entry.subpixelVariantCount) <= bundleSize - entry.fontTableOffset;
+
+            if (valid && entry.textureOffset != 0)
+            {
+                const unsigned long long pixelCount = static_cast<unsigned long long>(entry.textureWidth) * entry.textureHeight;
+                valid = entry.textureOffset % FONT_BUNDLE_ALIGNMENT == 0 && entry.textureOffset <= bundleSize &&
+                    entry.bytesPerPixel >= 1 && entry.bytesPerPixel <= 4 &&
+                    pixelCount <= bundleSize && pixelCount * entry.bytesPerPixel <= bundleSize - entry.textureOffset;
+            }
+
+            // FindFont probes with the hash, a wrong one would hide the font
+            if (valid)
+            {
+                const char* fontName = reinterpret_cast<const char*>(m_data + entry.nameOffset);
+                valid = entry.keyHash == GetFontBundleKeyHash(fontName, entry.nameLength, entry.fontSize_px);
+            }
+
+            if (!valid)
+            {
+                std::cerr << "ERROR: invalid font bundle entry" << std::endl;
+                m_fontSlots.clear();
+                return false;
+            }
+            m_fontSlots.push_back(slot);
+        }
+
+        if (m_fontSlots.size() != m_header->fontCount)
+        {
+            std::cerr << "ERROR: invalid font bundle font count" << std::endl;
+            m_fontSlots.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void FontBundle::SetView_H(FontBundleView& fontBundleView, const FontBundleEntry& entry) const
+    {
+        const unsigned char* fontTable = m_data + entry.fontTableOffset;
+
+        fontBundleView.fontName = reinterpret_cast<const char*>(m_data + entry.nameOffset);
+        fontBundleView.fontSize_px = entry.fontSize_px;
+        fontBundleView.lineSpacing_px = entry.lineSpacing_px;
+        fontBundleView.glyphCount = entry.glyphCount;
+        fontBundleView.subpixelVariantCount = entry.subpixelVariantCount;
+        fontBundleView.slotMap = reinterpret_cast<const unsigned short*>(fontTable);
+        fontBundleView.glyphs = reinterpret_cast<const FontBundleGlyph*>(fontTable + SLOT_MAP_SIZE);
+        fontBundleView.subpixelVariants = reinterpret_cast<const FontBundleSubpixelVariant*>(
+            fontTable + SLOT_MAP_SIZE + static_cast<size_t>(entry.glyphCount) * sizeof(FontBundleGlyph));
+
+        if (entry.textureOffset != 0)
+        {
+            fontBundleView.textureData = m_data + entry.textureOffset;
+            fontBundleView.textureWidth = entry.textureWidth;
+            fontBundleView.textureHeight = entry.textureHeight;
+            fontBundleView.bytesPerPixel = entry.bytesPerPixel;
+        }
+        else
+        {
+            fontBundleView.textureData = nullptr;
+            fontBundleView.textureWidth = 0;
+            fontBundleView.textureHeight = 0;
+            fontBundleView.bytesPerPixel = 0;
+        }
+    }
+}
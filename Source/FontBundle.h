@@ -0,0 +1,251 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include "FontData.h"
+#include "TextureData.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // A bundle holds many fonts and sizes in one file, laid out so a reader
+    // can map it and use the metrics and pixels where they are:
+    //
+    //     header            FontBundleHeader
+    //     directory         slotCount FontBundleEntry, hashed by name and size
+    //     names             every font name followed by a 0
+    //     per font          slot map, glyphs, subpixel variants
+    //     per font          texture pixels as in TextureData
+    //
+    // Every font table and texture starts at a multiple of
+    // FONT_BUNDLE_ALIGNMENT. Like the other formats it is written in the
+    // byte order of the machine. All offsets are from the start of the file.
+
+    static const size_t FONT_BUNDLE_ALIGNMENT = 64;
+
+    struct FontBundleHeader
+    {
+        static const unsigned int VERSION = 1;
+
+        char signature[8];                // "FSSBNDL"
+        unsigned int version;
+        unsigned int fontCount;
+        unsigned int slotCount;           // a power of two, at least twice fontCount
+        unsigned int reserved0;
+        unsigned long long directoryOffset;
+        unsigned long long fileSize;
+        unsigned int reserved1[6];
+    };
+
+    // An empty slot has a fontSize_px of 0. A font is looked up by probing
+    // from slot keyHash & (slotCount - 1) until its key or an empty slot.
+    struct FontBundleEntry
+    {
+        unsigned long long keyHash;       // GetFontBundleKeyHash of the name and size
+        unsigned long long nameOffset;
+        unsigned long long fontTableOffset;
+        unsigned long long textureOffset; // 0 without a texture
+
+        unsigned int fontSize_px;
+        unsigned int nameLength;          // without the terminating 0
+        unsigned int lineSpacing_px;
+        unsigned int glyphCount;
+        unsigned int subpixelVariantCount;
+        unsigned int textureWidth;
+        unsigned int textureHeight;
+        unsigned int bytesPerPixel;
+    };
+
+    // The font table starts with an unsigned short slot map of 256 entries,
+    // the index of each character's glyph or INVALID_SLOT. The glyphs follow
+    // sorted by character, then subpixelVariantCount - 1 variants per glyph.
+    struct FontBundleGlyph
+    {
+        static const unsigned short INVALID_SLOT = 0xFFFF;
+
+        unsigned char character;
+        unsigned char channel;
+        unsigned short reserved;
+
+        unsigned int width_px;
+        unsigned int height_px;
+        unsigned int horiBearingX_px;
+        unsigned int horiBearingY_px;
+        unsigned int horiAdvance_px;
+        unsigned int vertBearingX_px;
+        unsigned int vertBearingY_px;
+        unsigned int vertAdvance_px;
+
+        float textureLeft;
+        float textureRight;
+        float textureBottom;
+        float textureTop;
+    };
+
+    struct FontBundleSubpixelVariant
+    {
+        unsigned int width_px;
+        unsigned int horiBearingX_px;
+
+        float textureLeft;
+        float textureRight;
+        float textureBottom;
+        float textureTop;
+    };
+
+    static_assert(sizeof(FontBundleHeader) == 64, "the bundle header is 64 bytes");
+    static_assert(sizeof(FontBundleEntry) == 64, "a bundle entry is 64 bytes");
+    static_assert(sizeof(FontBundleGlyph) == 52, "a bundle glyph is 52 bytes");
+    static_assert(sizeof(FontBundleSubpixelVariant) == 24, "a bundle subpixel variant is 24 bytes");
+
+    // One font to write into a bundle, textureData may be empty
+    struct FontBundleSource
+    {
+        FontBundleSource();
+
+        std::string fontName;
+        unsigned int fontSize_px;
+        FontData fontData;
+        TextureData textureData;
+    };
+
+    inline FontBundleSource::FontBundleSource()
+        : fontSize_px(0)
+    {}
+
+    // Points into the bundle, valid as long as the FontBundle stays open
+    struct FontBundleView
+    {
+        FontBundleView();
+
+        // nullptr when the font has no glyph for character or the view is unset
+        const FontBundleGlyph* FindGlyph(unsigned char character) const;
+        // variant 1 to subpixelVariantCount - 1, variant 0 is the glyph itself
+        const FontBundleSubpixelVariant* FindSubpixelVariant(unsigned char character, unsigned int variant) const;
+
+        const char* fontName;
+        unsigned int fontSize_px;
+        unsigned int lineSpacing_px;
+
+        unsigned int glyphCount;
+        unsigned int subpixelVariantCount;
+        const unsigned short* slotMap; // 256 entries
+        const FontBundleGlyph* glyphs;
+        const FontBundleSubpixelVariant* subpixelVariants;
+
+        const unsigned char* textureData; // nullptr without a texture
+        unsigned int textureWidth;
+        unsigned int textureHeight;
+        unsigned int bytesPerPixel;
+    };
+
+    inline FontBundleView::FontBundleView()
+        : fontName(nullptr)
+        , fontSize_px(0)
+        , lineSpacing_px(0)
+        , glyphCount(0)
+        , subpixelVariantCount(1)
+        , slotMap(nullptr)
+        , glyphs(nullptr)
+        , subpixelVariants(nullptr)
+        , textureData(nullptr)
+        , textureWidth(0)
+        , textureHeight(0)
+        , bytesPerPixel(0)
+    {}
+
+    inline const FontBundleGlyph* FontBundleView::FindGlyph(unsigned char character) const
+    {
+        if (slotMap == nullptr)
+        {
+            return nullptr;
+        }
+        unsigned short slot = slotMap[character];
+        return slot < glyphCount ? glyphs + slot : nullptr;
+    }
+
+    inline const FontBundleSubpixelVariant* FontBundleView::FindSubpixelVariant(unsigned char character, unsigned int variant) const
+    {
+        if (slotMap == nullptr)
+        {
+            return nullptr;
+        }
+        unsigned short slot = slotMap[character];
+        if (slot >= glyphCount || variant == 0 || variant >= subpixelVariantCount)
+        {
+            return nullptr;
+        }
+        return subpixelVariants + static_cast<size_t>(slot) * (subpixelVariantCount - 1) + (variant - 1);
+    }
+
+    // Maps a bundle file once and hands out views of its fonts, nothing is
+    // copied or parsed beyond checking the directory. The pages of a font
+    // are only read from disk when its view is first used. Move only.
+    struct FontBundle
+    {
+        FontBundle();
+        ~FontBundle();
+
+        FontBundle(const FontBundle&) = delete;
+        FontBundle& operator=(const FontBundle&) = delete;
+
+        FontBundle(FontBundle&& other) noexcept;
+        FontBundle& operator=(FontBundle&& other) noexcept;
+
+        // Maps the file read only, with mmap or CreateFileMapping
+        bool Open(const std::string& filePath);
+
+        // Uses a bundle the caller keeps in memory, aligned to at least 8 bytes
+        bool Open(const unsigned char* dataPtr, size_t dataSize);
+
+        void Close();
+
+        bool IsOpen() const;
+        unsigned int GetFontCount() const;
+
+        // index is 0 to GetFontCount() - 1, in directory order
+        bool GetFont(FontBundleView& fontBundleView, unsigned int index) const;
+
+        bool FindFont(FontBundleView& fontBundleView, const std::string& fontName, unsigned int fontSize_px) const;
+
+    private:
+        bool ValidateDirectory_H();
+        void SetView_H(FontBundleView& fontBundleView, const FontBundleEntry& entry) const;
+
+        const unsigned char* m_data;
+        size_t m_size;
+        bool m_mapped; // unmapped by Close, otherwise the memory is the caller's
+        const FontBundleHeader* m_header;
+        const FontBundleEntry* m_directory;
+        std::vector<unsigned int> m_fontSlots;
+    };
+
+    // FNV-1a over the name and the size
+    unsigned long long GetFontBundleKeyHash(
+        const char* fontName,
+        size_t nameLength,
+        unsigned int fontSize_px);
+
+    // Fails if two sources share a name and size or a font name is empty.
+    // Appends to buffer like the other Encode functions, the offsets in the
+    // bundle are from where it starts in buffer.
+    bool EncodeFontBundle(
+        std::vector<unsigned char>& buffer,
+        const std::vector<FontBundleSource>& fontBundleSources);
+
+    bool WriteFontBundle(
+        const std::vector<FontBundleSource>& fontBundleSources,
+        const std::string& filePath);
+
+    // Copies a view into FontData for code that wants the regular structures
+    void ConvertFromFontBundleView(
+        FontData& fontData,
+        const FontBundleView& fontBundleView);
+}
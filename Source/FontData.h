@@ -5,6 +5,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 
 
@@ -12,6 +13,11 @@ namespace ftss
 {
     struct GlyphMetrics
     {
+        // coverage is in the alpha channel unless several fonts share a texture
+        static const unsigned char ALPHA_CHANNEL = 3;
+
+        GlyphMetrics();
+
         bool operator==(const GlyphMetrics& other) const;
         bool operator!=(const GlyphMetrics& other) const;
 
@@ -28,8 +34,26 @@ namespace ftss
         float textureRight;
         float textureBottom;
         float textureTop;
+
+        unsigned char channel; // 0 to 3 for R, G, B and A
     };
 
+    inline GlyphMetrics::GlyphMetrics()
+        : width_px(0)
+        , height_px(0)
+        , horiBearingX_px(0)
+        , horiBearingY_px(0)
+        , horiAdvance_px(0)
+        , vertBearingX_px(0)
+        , vertBearingY_px(0)
+        , vertAdvance_px(0)
+        , textureLeft(0.0f)
+        , textureRight(0.0f)
+        , textureBottom(0.0f)
+        , textureTop(0.0f)
+        , channel(ALPHA_CHANNEL)
+    {}
+
     inline bool GlyphMetrics::operator==(const GlyphMetrics& other) const
     {
         return width_px == other.width_px &&
@@ -43,7 +67,8 @@ namespace ftss
             textureLeft == other.textureLeft &&
             textureRight == other.textureRight &&
             textureBottom == other.textureBottom &&
-            textureTop == other.textureTop;
+            textureTop == other.textureTop &&
+            channel == other.channel;
     }
 
     inline bool GlyphMetrics::operator!=(const GlyphMetrics& other) const
@@ -51,8 +76,52 @@ namespace ftss
         return !(*this == other);
     }
 
+    // A glyph rendered shifted right by a fraction of a pixel. Only the
+    // horizontal metrics differ from the unshifted glyph.
+    struct SubpixelVariant
+    {
+        SubpixelVariant();
+
+        bool operator==(const SubpixelVariant& other) const;
+        bool operator!=(const SubpixelVariant& other) const;
+
+        unsigned int width_px;
+        unsigned int horiBearingX_px;
+
+        float textureLeft;
+        float textureRight;
+        float textureBottom;
+        float textureTop;
+    };
+
+    inline SubpixelVariant::SubpixelVariant()
+        : width_px(0)
+        , horiBearingX_px(0)
+        , textureLeft(0.0f)
+        , textureRight(0.0f)
+        , textureBottom(0.0f)
+        , textureTop(0.0f)
+    {}
+
+    inline bool SubpixelVariant::operator==(const SubpixelVariant& other) const
+    {
+        return width_px == other.width_px &&
+            horiBearingX_px == other.horiBearingX_px &&
+            textureLeft == other.textureLeft &&
+            textureRight == other.textureRight &&
+            textureBottom == other.textureBottom &&
+            textureTop == other.textureTop;
+    }
+
+    inline bool SubpixelVariant::operator!=(const SubpixelVariant& other) const
+    {
+        return !(*this == other);
+    }
+
     struct FontData
     {
+        static const unsigned int MAX_SUBPIXEL_VARIANT_COUNT = 64;
+
         FontData();
 
         void Clear();
@@ -62,15 +131,25 @@ namespace ftss
 
         unsigned int lineSpacing_px;
         std::unordered_map<unsigned char, GlyphMetrics> glyphMetricsMap;
+
+        // Glyph v of subpixelVariantCount is shifted right by
+        // v / subpixelVariantCount of a pixel, a renderer picks it with the
+        // fraction of the pen position. Variant 0 is glyphMetricsMap, the
+        // map holds variants 1 to subpixelVariantCount - 1 of each glyph.
+        unsigned int subpixelVariantCount;
+        std::unordered_map<unsigned char, std::vector<SubpixelVariant>> subpixelVariantMap;
     };
 
     inline FontData::FontData()
         : lineSpacing_px(0)
+        , subpixelVariantCount(1)
     {}
 
     inline void FontData::Clear()
     {
         glyphMetricsMap.clear();
+        subpixelVariantCount = 1;
+        subpixelVariantMap.clear();
     }
 
     inline bool FontData::operator==(const FontData& other) const
@@ -91,6 +170,19 @@ namespace ftss
                 return false;
             }
         }
+        if (subpixelVariantCount != other.subpixelVariantCount ||
+            subpixelVariantMap.size() != other.subpixelVariantMap.size())
+        {
+            return false;
+        }
+        for (const auto& pair : subpixelVariantMap)
+        {
+            auto it = other.subpixelVariantMap.find(pair.first);
+            if (it == other.subpixelVariantMap.end() || pair.second != it->second)
+            {
+                return false;
+            }
+        }
         return true;
     }
 
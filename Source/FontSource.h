@@ -0,0 +1,53 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // A single face inside a font file. For TrueType/OpenType collections
+    // (.ttc/.otc) faceIndex selects the face, for plain font files it is 0.
+    struct FontSource
+    {
+        FontSource();
+        FontSource(const std::string& filePath, long faceIndex = 0);
+
+        std::string filePath;
+        long faceIndex;
+    };
+
+    inline FontSource::FontSource()
+        : faceIndex(0)
+    {}
+
+    inline FontSource::FontSource(const std::string& filePath, long faceIndex)
+        : filePath(filePath)
+        , faceIndex(faceIndex)
+    {}
+
+    // What one channel of a channel packed texture is baked from, a font
+    // chain like LoadTextureDataAndFontDataFromFontChain takes and a size
+    struct ChannelSource
+    {
+        ChannelSource();
+        ChannelSource(const std::vector<FontSource>& fontSources, unsigned int fontHeightInPixels);
+
+        std::vector<FontSource> fontSources;
+        unsigned int fontHeightInPixels;
+    };
+
+    inline ChannelSource::ChannelSource()
+        : fontHeightInPixels(48)
+    {}
+
+    inline ChannelSource::ChannelSource(const std::vector<FontSource>& fontSources, unsigned int fontHeightInPixels)
+        : fontSources(fontSources)
+        , fontHeightInPixels(fontHeightInPixels)
+    {}
+}
@@ -7,18 +7,165 @@
 // http://freetype.sourceforge.net/freetype2/docs/reference/ft2-index.html
 #include "ft2build.h"
 #include FT_FREETYPE_H
+#include FT_GLYPH_H
+#include FT_OUTLINE_H
+#include FT_STROKER_H
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <set>
+#include <sstream>
+#include <thread>
 
 
 
 namespace ftss
 {
+    static const int METRICS_UNIT_MULTIPLIER = 64; // because values are expressed in 26.6 fractional pixel format
+
+    // curves are split into at most this many edges when flattening outlines
+    static const unsigned int MAX_CURVE_SEGMENTS = 64;
+
+    // FT_Outline_Decompose callbacks that flatten an outline into edges
+    struct OutlineFlattener
+    {
+        GlyphOutline* glyphOutline;
+        float tolerance;
+        float x;
+        float y;
+    };
+
+    static void AddOutlineEdge_H(OutlineFlattener& flattener, float x, float y)
+    {
+        OutlineEdge edge = { flattener.x, flattener.y, x, y };
+        flattener.glyphOutline->edges.push_back(edge);
+        flattener.x = x;
+        flattener.y = y;
+    }
+
+    static unsigned int GetCurveSegmentCount_H(float deviation, float tolerance)
+    {
+        // a curve with this second difference strays at most deviation / (4 * n^2)
+        // from its n edges, deviation being scaled to match for cubic curves
+        float segmentCount = std::ceil(std::sqrt(deviation / (4.0f * tolerance)));
+        return static_cast<unsigned int>(std::min(std::max(segmentCount, 1.0f), static_cast<float>(MAX_CURVE_SEGMENTS)));
+    }
+
+    static int FlattenMoveTo_H(const FT_Vector* to, void* user)
+    {
+        // FT_Outline_Decompose closes every contour with a line before moving on
+        OutlineFlattener& flattener = *static_cast<OutlineFlattener*>(user);
+        flattener.x = static_cast<float>(to->x);
+        flattener.y = static_cast<float>(to->y);
+        return 0;
+    }
+
+    static int FlattenLineTo_H(const FT_Vector* to, void* user)
+    {
+        AddOutlineEdge_H(*static_cast<OutlineFlattener*>(user), static_cast<float>(to->x), static_cast<float>(to->y));
+        return 0;
+    }
+
+    static int FlattenConicTo_H(const FT_Vector* control, const FT_Vector* to, void* user)
+    {
+        OutlineFlattener& flattener = *static_cast<OutlineFlattener*>(user);
+        float x0 = flattener.x;
+        float y0 = flattener.y;
+        float x1 = static_cast<float>(control->x);
+        float y1 = static_cast<float>(control->y);
+        float x2 = static_cast<float>(to->x);
+        float y2 = static_cast<float>(to->y);
+
+        float deviation = std::hypot(x0 - 2.0f * x1 + x2, y0 - 2.0f * y1 + y2);
+        unsigned int segmentCount = GetCurveSegmentCount_H(deviation, flattener.tolerance);
+        for (unsigned int i = 1; i <= segmentCount; ++i)
+        {
+            float t = static_cast<float>(i) / static_cast<float>(segmentCount);
+            float u = 1.0f - t;
+            AddOutlineEdge_H(
+                flattener,
+                u * u * x0 + 2.0f * u * t * x1 + t * t * x2,
+                u * u * y0 + 2.0f * u * t * y1 + t * t * y2);
+        }
+        return 0;
+    }
+
+    static int FlattenCubicTo_H(const FT_Vector* control1, const FT_Vector* control2, const FT_Vector* to, void* user)
+    {
+        OutlineFlattener& flattener = *static_cast<OutlineFlattener*>(user);
+        float x0 = flattener.x;
+        float y0 = flattener.y;
+        float x1 = static_cast<float>(control1->x);
+        float y1 = static_cast<float>(control1->y);
+        float x2 = static_cast<float>(control2->x);
+        float y2 = static_cast<float>(control2->y);
+        float x3 = static_cast<float>(to->x);
+        float y3 = static_cast<float>(to->y);
+
+        float deviation = 3.0f * std::max(
+            std::hypot(x0 - 2.0f * x1 + x2, y0 - 2.0f * y1 + y2),
+            std::hypot(x1 - 2.0f * x2 + x3, y1 - 2.0f * y2 + y3));
+        unsigned int segmentCount = GetCurveSegmentCount_H(deviation, flattener.tolerance);
+        for (unsigned int i = 1; i <= segmentCount; ++i)
+        {
+            float t = static_cast<float>(i) / static_cast<float>(segmentCount);
+            float u = 1.0f - t;
+            AddOutlineEdge_H(
+                flattener,
+                u * u * u * x0 + 3.0f * u * u * t * x1 + 3.0f * u * t * t * x2 + t * t * t * x3,
+                u * u * u * y0 + 3.0f * u * u * t * y1 + 3.0f * u * t * t * y2 + t * t * t * y3);
+        }
+        return 0;
+    }
+
+    // Calls work(i, scratch) for every i below glyphCount on up to
+    // threadCount threads, 0 being all hardware threads, the calling thread
+    // being one of them. Each thread takes the next glyph when it is done
+    // with one and has a Scratch of its own to reuse between its glyphs.
+    // Whatever work writes to has to exist before, so the threads only
+    // touch their own glyphs.
+    template<typename Scratch, typename Work>
+    static void ForEachGlyphInParallel_H(size_t glyphCount, unsigned int threadCount, Work work)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        threadCount = std::min(threadCount, static_cast<unsigned int>(std::max<size_t>(glyphCount, 1)));
+
+        std::atomic<size_t> nextGlyph(0);
+        auto workOnGlyphs = [&]()
+        {
+            Scratch scratch;
+            for (size_t i = nextGlyph++; i < glyphCount; i = nextGlyph++)
+            {
+                work(i, scratch);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(workOnGlyphs);
+        }
+        workOnGlyphs();
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
     // public ------------------------------------------------------------------
 
     bool LoadCharacterListFromFile(
@@ -61,7 +208,8 @@ namespace ftss
         const std::string& filePath,
         unsigned int fontHeightInPixels,
         unsigned int horizontalSpacing,
-        unsigned int verticalSpacing)
+        unsigned int verticalSpacing,
+        long faceIndex)
     {
         FT_Library library;
         FT_Error error = FT_Init_FreeType(&library);
@@ -72,13 +220,14 @@ namespace ftss
         }
 
         FT_Face face;
-        error = FT_New_Face(library, filePath.c_str(), 0, &face);
+        error = FT_New_Face(library, filePath.c_str(), faceIndex, &face);
         if (error) {
             std::cerr << "ERROR: failed to load the font" << std::endl;
+            FT_Done_FreeType(library);
             return false;
         }
 
-        return LoadTextureDataAndFontData_H(
+        bool result = LoadTextureDataAndFontData_H(
             textureData,
             fontData,
             characterList,
@@ -87,6 +236,11 @@ namespace ftss
             horizontalSpacing,
             verticalSpacing
         );
+
+        FT_Done_Face(face);
+        FT_Done_FreeType(library);
+
+        return result;
     }
 
     bool LoadTextureDataAndFontDataFromMemory(
@@ -97,7 +251,8 @@ namespace ftss
         size_t dataSize,
         unsigned int fontHeightInPixels,
         unsigned int horizontalSpacing,
-        unsigned int verticalSpacing)
+        unsigned int verticalSpacing,
+        long faceIndex)
     {
         FT_Library library;
         FT_Error error = FT_Init_FreeType(&library);
@@ -108,13 +263,14 @@ namespace ftss
         }
 
         FT_Face face;
-        error = FT_New_Memory_Face(library, dataPtr, dataSize, 0, &face);
+        error = FT_New_Memory_Face(library, dataPtr, dataSize, faceIndex, &face);
         if (error) {
             std::cerr << "ERROR: failed to load the font" << std::endl;
+            FT_Done_FreeType(library);
             return false;
         }
 
-        return LoadTextureDataAndFontData_H(
+        bool result = LoadTextureDataAndFontData_H(
             textureData,
             fontData,
             characterList,
@@ -123,390 +279,2650 @@ namespace ftss
             horizontalSpacing,
             verticalSpacing
         );
+
+        FT_Done_Face(face);
+        FT_Done_FreeType(library);
+
+        return result;
     }
 
-    bool WriteTextureData(
-        const TextureData& textureData,
-        const std::string& filePath)
+    bool LoadTextureDataAndFontDataFromFontChain(
+        TextureData& textureData,
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources,
+        unsigned int fontHeightInPixels,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        unsigned int subpixelVariantCount,
+        const std::vector<unsigned char>& packOrder)
     {
-        if (textureData.data == nullptr || textureData.width == 0 || textureData.height == 0)
+        FT_Library library;
+        std::vector<FT_Face> faces;
+        if (!OpenFontSources_H(library, faces, fontSources))
         {
-            std::cerr << "Error: invalid texture data" << std::endl;
             return false;
         }
 
-        int stride_in_bytes = textureData.width * textureData.bytesPerPixel;
-        int success = stbi_write_png(
-            filePath.c_str(),          // output file path
-            textureData.width,
-            textureData.height,
-            textureData.bytesPerPixel, // channels per pixel (e.g., 3 for RGB, 4 for RGBA)
-            textureData.data,          // pointer to the pixel data
-            stride_in_bytes            // stride (number of bytes per row)
+        bool result = LoadTextureDataAndFontData_H(
+            textureData,
+            fontData,
+            glyphSourceMap,
+            characterList,
+            faces,
+            fontHeightInPixels,
+            horizontalSpacing,
+            verticalSpacing,
+            subpixelVariantCount,
+            packOrder
         );
 
-        if (success == 0)
+        CloseFontSources_H(library, faces);
+
+        return result;
+    }
+
+    bool LoadTextureDataAndFontDataIncremental(
+        TextureData& textureData,
+        FontData& fontData,
+        GlyphCache& glyphCache,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources,
+        unsigned int fontHeightInPixels,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        unsigned int subpixelVariantCount)
+    {
+        FT_Library library;
+        std::vector<FT_Face> faces;
+        if (!OpenFontSources_H(library, faces, fontSources))
         {
-            std::cerr << "Error: failed to save the texture" << std::endl;
             return false;
         }
 
-        return true;
+        // glyphs that are no longer in the character list must not stay behind
+        fontData.Clear();
+
+        bool result = LoadTextureDataAndFontData_H(
+            textureData,
+            fontData,
+            glyphCache,
+            glyphSourceMap,
+            characterList,
+            faces,
+            fontHeightInPixels,
+            horizontalSpacing,
+            verticalSpacing,
+            subpixelVariantCount
+        );
+
+        CloseFontSources_H(library, faces);
+
+        return result;
     }
 
-    bool WriteFontData(
-        const FontData& fontData,
-        const std::string& filePath)
+    bool LoadChannelPackedTextureData(
+        TextureData& textureData,
+        std::vector<FontData>& fontDatas,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<ChannelSource>& channelSources,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing)
     {
-        std::ofstream fileStream(filePath, std::ios::binary);
+        const size_t CHANNEL_COUNT = 4;
 
-        if (!fileStream.is_open())
+        if (channelSources.empty() || channelSources.size() > CHANNEL_COUNT)
         {
-            std::cerr << "ERROR: failed to open file" << std::endl;
+            std::cerr << "ERROR: a texture holds 1 to " << CHANNEL_COUNT << " channels" << std::endl;
             return false;
         }
 
-        const char signature[] = "FSSDATA";
-        fileStream.write(signature, 8); // ------------------------------------------------- 8 bytes
-        unsigned int version = 1;
-        fileStream.write(reinterpret_cast<const char*>(&version), 4); // ------------------- 4 bytes
+        fontDatas.assign(channelSources.size(), FontData());
+        std::vector<GlyphCache> glyphCaches(channelSources.size());
+        std::vector<std::unordered_map<unsigned char, unsigned int>> glyphOffsetXMaps(channelSources.size());
+        unsigned int textureWidth = 0;
+        unsigned int textureHeight = 0;
+        for (size_t i = 0; i < channelSources.size(); ++i)
+        {
+            FT_Library library;
+            std::vector<FT_Face> faces;
+            if (!OpenFontSources_H(library, faces, channelSources[i].fontSources))
+            {
+                return false;
+            }
 
-        fileStream.write(reinterpret_cast<const char*>(&fontData.lineSpacing_px), 4); // --- 4 bytes
-        unsigned int glyphCount = fontData.glyphMetricsMap.size();
-        fileStream.write(reinterpret_cast<const char*>(&glyphCount), 4); // ---------------- 4 bytes
+            std::unordered_map<unsigned char, unsigned int> glyphSourceMap;
+            bool result = RenderGlyphBitmaps_H(
+                fontDatas[i],
+                glyphCaches[i],
+                glyphSourceMap,
+                characterList,
+                faces,
+                channelSources[i].fontHeightInPixels);
 
-        for (const auto& pair : fontData.glyphMetricsMap) {
-            unsigned char glyph = pair.first;
-            fileStream.write(reinterpret_cast<const char*>(&glyph), 1); // ----------------- 1 byte
+            CloseFontSources_H(library, faces);
 
-            const GlyphMetrics& metrics = pair.second;
-            fileStream.write(reinterpret_cast<const char*>(&metrics.width_px), 4); // ------ 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.height_px), 4); // ----- 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.horiBearingX_px), 4); // 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.horiBearingY_px), 4); // 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.horiAdvance_px), 4); //  4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.vertBearingX_px), 4); // 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.vertBearingY_px), 4); // 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.vertAdvance_px), 4); //  4 bytes
+            if (!result)
+            {
+                return false;
+            }
 
-            fileStream.write(reinterpret_cast<const char*>(&metrics.textureLeft), 4); // --- 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.textureRight), 4); // -- 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.textureBottom), 4); // - 4 bytes
-            fileStream.write(reinterpret_cast<const char*>(&metrics.textureTop), 4); // ---- 4 bytes
-        }
+            for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = fontDatas[i].glyphMetricsMap.begin(); iter != fontDatas[i].glyphMetricsMap.end(); ++iter)
+            {
+                iter->second = glyphCaches[i].glyphBitmapMap.at(iter->first).metrics;
+                iter->second.channel = static_cast<unsigned char>(i);
+            }
 
-        fileStream.close();
+            // glyphs of different channels may overlap, so every channel is
+            // laid out as if it had the texture to itself
+            unsigned int channelWidth;
+            unsigned int channelHeight;
+            PackFontData_H(
+                fontDatas[i],
+                glyphOffsetXMaps[i],
+                channelWidth,
+                channelHeight,
+                horizontalSpacing,
+                verticalSpacing);
+            textureWidth = std::max(textureWidth, channelWidth);
+            textureHeight = std::max(textureHeight, channelHeight);
+        }
 
-        if (fileStream.bad())
+        if (!textureData.Allocate(textureWidth, textureHeight, 4))
         {
-            std::cerr << "ERROR: file stream error" << std::endl;
+            std::cerr << "ERROR: memory allocation failed" << std::endl;
             return false;
         }
 
+        std::memset(textureData.data, 0, textureData.GetSize());
+
+        for (size_t i = 0; i < channelSources.size(); ++i)
+        {
+            SetTextureCoordinates_H(
+                fontDatas[i],
+                glyphOffsetXMaps[i],
+                textureWidth,
+                textureHeight,
+                horizontalSpacing,
+                verticalSpacing);
+
+            ComposeTextureChannel_H(
+                textureData,
+                fontDatas[i],
+                glyphCaches[i].glyphBitmapMap,
+                glyphOffsetXMaps[i],
+                verticalSpacing,
+                static_cast<unsigned char>(i));
+        }
+
         return true;
     }
 
-    bool ReadFontData(
+    bool LoadTextureDataAndFontDataWithEffects(
+        TextureData& textureData,
         FontData& fontData,
-        const std::string& filePath)
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources,
+        const EffectSettings& effectSettings,
+        unsigned int fontHeightInPixels,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        unsigned int threadCount,
+        const std::vector<unsigned char>& packOrder)
     {
-        std::ifstream fileStream(filePath, std::ios::binary);
+        const size_t CHANNEL_COUNT = 4;
 
-        if (!fileStream.is_open())
+        if (effectSettings.outlineRadius_px > EffectSettings::MAX_RADIUS_PX ||
+            effectSettings.glowRadius_px > EffectSettings::MAX_RADIUS_PX ||
+            effectSettings.shadowRadius_px > EffectSettings::MAX_RADIUS_PX ||
+            std::abs(effectSettings.shadowOffsetX_px) > static_cast<int>(EffectSettings::MAX_RADIUS_PX) ||
+            std::abs(effectSettings.shadowOffsetY_px) > static_cast<int>(EffectSettings::MAX_RADIUS_PX))
         {
-            std::cerr << "ERROR: failed to open file" << std::endl;
+            std::cerr << "ERROR: effect radii and offsets go up to " << EffectSettings::MAX_RADIUS_PX << " pixels" << std::endl;
             return false;
         }
 
-        char signature[8] = { 0 };
-        fileStream.read(signature, 8); // ------------------------------------------- 8 bytes
-        if (std::string(signature) != "FSSDATA")
+        FT_Library library;
+        std::vector<FT_Face> faces;
+        if (!OpenFontSources_H(library, faces, fontSources))
         {
-            std::cerr << "ERROR: invalid file signature" << std::endl;
             return false;
         }
 
-        unsigned int version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), 4); // ------------------- 4 bytes
-        if (version != 1)
+        GlyphCache glyphCache;
+        bool result = RenderGlyphBitmaps_H(
+            fontData,
+            glyphCache,
+            glyphSourceMap,
+            characterList,
+            faces,
+            fontHeightInPixels);
+
+        // FreeType faces aren't thread safe, the strokes are rendered here
+        // and only the rest of the effects run on several threads
+        std::unordered_map<unsigned char, GlyphBitmap> outlineBitmapMap;
+        for (std::unordered_map<unsigned char, GlyphBitmap>::iterator iter = glyphCache.glyphBitmapMap.begin(); result && effectSettings.outlineRadius_px > 0 && iter != glyphCache.glyphBitmapMap.end(); ++iter)
         {
-            std::cerr << "ERROR: unsupported version" << std::endl;
-            return false;
+            bool stroked = false;
+            GlyphBitmap outlineBitmap;
+            result = RenderOutlineBitmap_H(
+                outlineBitmap,
+                stroked,
+                library,
+                faces[iter->second.sourceIndex],
+                iter->first,
+                effectSettings.outlineRadius_px);
+            if (stroked)
+            {
+                outlineBitmapMap[iter->first] = std::move(outlineBitmap);
+            }
         }
 
-        fileStream.read(reinterpret_cast<char*>(&fontData.lineSpacing_px), 4); // --- 4 bytes
-
-        unsigned int glyphCount = 0;
-        fileStream.read(reinterpret_cast<char*>(&glyphCount), 4); // ---------------- 4 bytes
+        CloseFontSources_H(library, faces);
 
-        // fontData.glyphMetricsMap.clear();
+        if (!result)
+        {
+            return false;
+        }
 
-        for (unsigned int i = 0; i < glyphCount; ++i)
+        std::vector<std::unordered_map<unsigned char, GlyphBitmap>> layerBitmapMaps(CHANNEL_COUNT);
+        ApplyGlyphEffects_H(
+            layerBitmapMaps,
+            glyphCache.glyphBitmapMap,
+            outlineBitmapMap,
+            effectSettings,
+            threadCount);
+
+        const std::unordered_map<unsigned char, GlyphBitmap>& fillBitmapMap = layerBitmapMaps[GlyphMetrics::ALPHA_CHANNEL];
+        fontData.subpixelVariantCount = 1;
+        fontData.subpixelVariantMap.clear();
+        for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = fontData.glyphMetricsMap.begin(); iter != fontData.glyphMetricsMap.end(); ++iter)
         {
-            unsigned char glyph;
-            fileStream.read(reinterpret_cast<char*>(&glyph), 1); // ----------------- 1 byte
+            iter->second = fillBitmapMap.at(iter->first).metrics;
+        }
 
-            GlyphMetrics metrics;
-            fileStream.read(reinterpret_cast<char*>(&metrics.width_px), 4); // ------ 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.height_px), 4); // ----- 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.horiBearingX_px), 4); // 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.horiBearingY_px), 4); // 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.horiAdvance_px), 4); //  4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.vertBearingX_px), 4); // 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.vertBearingY_px), 4); // 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.vertAdvance_px), 4); //  4 bytes
-
-            fileStream.read(reinterpret_cast<char*>(&metrics.textureLeft), 4); // --- 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.textureRight), 4); // -- 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.textureBottom), 4); // - 4 bytes
-            fileStream.read(reinterpret_cast<char*>(&metrics.textureTop), 4); // ---- 4 bytes
+        std::unordered_map<unsigned char, unsigned int> glyphOffsetXMap;
+        unsigned int textureWidth;
+        unsigned int textureHeight;
+        PackFontData_H(
+            fontData,
+            glyphOffsetXMap,
+            textureWidth,
+            textureHeight,
+            horizontalSpacing,
+            verticalSpacing,
+            packOrder);
 
-            fontData.glyphMetricsMap[glyph] = metrics;
+        if (!textureData.Allocate(textureWidth, textureHeight, 4))
+        {
+            std::cerr << "ERROR: memory allocation failed" << std::endl;
+            return false;
         }
 
-        fileStream.close();
+        // channels of effects that are left out stay empty
+        std::memset(textureData.data, 0, textureData.GetSize());
 
-        if (fileStream.bad())
+        for (size_t i = 0; i < CHANNEL_COUNT; ++i)
         {
-            std::cerr << "ERROR: file stream error" << std::endl;
-            return false;
+            if (!layerBitmapMaps[i].empty())
+            {
+                ComposeTextureChannel_H(
+                    textureData,
+                    fontData,
+                    layerBitmapMaps[i],
+                    glyphOffsetXMap,
+                    verticalSpacing,
+                    static_cast<unsigned char>(i));
+            }
         }
 
         return true;
     }
 
-    // protected ---------------------------------------------------------------
-
-    bool LoadTextureDataAndFontData_H(
-        TextureData& textureData,
-        FontData& fontData,
+    bool LoadOutlineCache(
+        OutlineCache& outlineCache,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
         const std::vector<unsigned char>& characterList,
-        FT_Face face,
-        unsigned int fontHeightInPixels,
-        unsigned int horizontalSpacing,
-        unsigned int verticalSpacing)
+        const std::vector<FontSource>& fontSources)
     {
-        FT_Error error = FT_Set_Pixel_Sizes(face, 0, fontHeightInPixels);
-        if (error)
+        FT_Library library;
+        std::vector<FT_Face> faces;
+        if (!OpenFontSources_H(library, faces, fontSources))
         {
-            std::cerr << "ERROR: could not set font pixel sizes" << std::endl;
             return false;
         }
 
-        std::unordered_map<unsigned char, GlyphMetrics>& glyphMetricsMap = fontData.glyphMetricsMap;
-
-        for (size_t i = 0; i < characterList.size(); ++i)
+        outlineCache.Clear();
+        outlineCache.outlineSources.resize(faces.size());
+        for (size_t i = 0; i < faces.size(); ++i)
         {
-            const unsigned char& c = characterList[i];
-            if (fontData.glyphMetricsMap.find(c) != fontData.glyphMetricsMap.end())
+            if (!FT_IS_SCALABLE(faces[i]))
             {
-                std::cout << "WARNING: reloading character glyph for: " << c << std::endl;
+                std::cerr << "ERROR: font has no outlines: " << fontSources[i].filePath << std::endl;
+                CloseFontSources_H(library, faces);
+                return false;
             }
-            else
+            outlineCache.outlineSources[i].unitsPerEm = static_cast<float>(faces[i]->units_per_EM);
+            outlineCache.outlineSources[i].lineSpacing = static_cast<float>(faces[i]->height);
+        }
+
+        std::vector<unsigned char> characters;
+        std::vector<bool> characterAdded(256, false);
+        for (unsigned char c : characterList)
+        {
+            if (!characterAdded[c])
             {
-                glyphMetricsMap[c];
+                characterAdded[c] = true;
+                characters.push_back(c);
             }
         }
 
-        const unsigned int METRICS_UNIT_MULTIPLIER = 64; // because values are expressed in 26.6 fractional pixel format
-        fontData.lineSpacing_px = face->size->metrics.height / METRICS_UNIT_MULTIPLIER;
+        std::vector<bool> faceUsed;
+        ResolveGlyphSources_H(glyphSourceMap, faceUsed, characters, faces);
 
-        // load characters first time to calculate the size of the texture
-        for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = glyphMetricsMap.begin(); iter != glyphMetricsMap.end(); ++iter)
+        bool result = true;
+        for (size_t i = 0; i < faces.size(); ++i)
         {
-            const unsigned char& c = iter->first;
-            error = FT_Load_Char(face, c, FT_LOAD_RENDER);
-            if (error)
-            {
-                std::cerr << "ERROR: could not load character glyph for: " << c << std::endl;
-                return false;
-            }
+            outlineCache.outlineSources[i].used = faceUsed[i];
+        }
+        for (unsigned char c : characters)
+        {
+            unsigned int sourceIndex = glyphSourceMap[c];
 
-            unsigned char& pixelMode = face->glyph->bitmap.pixel_mode;
-            if (pixelMode != FT_Pixel_Mode::FT_PIXEL_MODE_GRAY)
-            {
-                std::cerr << "ERROR: glyph pixel mode not supported" << std::endl;
-                return false;
-            }
+            // edges stay within 1/4096 em of the curves, a small fraction of a pixel at any usual size
+            float tolerance = outlineCache.outlineSources[sourceIndex].unitsPerEm / 4096.0f;
 
-            unsigned int& currentBitmapHeight = face->glyph->bitmap.rows;
-            unsigned int& currentBitmapWidth = face->glyph->bitmap.width;
-            if (currentBitmapHeight + verticalSpacing * 2 > textureData.height)
+            GlyphOutline& glyphOutline = outlineCache.glyphOutlineMap[c];
+            if (!LoadGlyphOutline_H(glyphOutline, faces[sourceIndex], c, tolerance))
             {
-                textureData.height = currentBitmapHeight + verticalSpacing * 2;
+                result = false;
+                break;
             }
-            textureData.width += currentBitmapWidth + horizontalSpacing;
+            glyphOutline.sourceIndex = sourceIndex;
         }
-        textureData.width += horizontalSpacing;
 
-        free(textureData.data);
-        textureData.data = (unsigned char*)malloc(sizeof(unsigned char*) * textureData.height * textureData.width * 4);
-        if (textureData.data == nullptr)
+        CloseFontSources_H(library, faces);
+
+        return result;
+    }
+
+    bool LoadTextureDataAndFontDataFromOutlineCache(
+        TextureData& textureData,
+        FontData& fontData,
+        const OutlineCache& outlineCache,
+        unsigned int fontHeightInPixels,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        unsigned int threadCount,
+        const std::vector<unsigned char>& packOrder)
+    {
+        std::unordered_map<unsigned char, GlyphBitmap> glyphBitmapMap;
+        if (!RasterizeOutlineCache_H(glyphBitmapMap, outlineCache, fontHeightInPixels, threadCount))
         {
-            std::cerr << "ERROR: memory allocation failed" << std::endl;
             return false;
         }
 
-        // top side spacing
-        for (unsigned int j = 0; j < verticalSpacing; ++j)
+        // same line spacing FreeType reports for unhinted scalable fonts
+        fontData.Clear();
+        fontData.lineSpacing_px = 0;
+        for (const OutlineSource& outlineSource : outlineCache.outlineSources)
         {
-            for (unsigned int i = 0; i < textureData.width; ++i)
+            float scale = static_cast<float>(fontHeightInPixels) / outlineSource.unitsPerEm;
+            unsigned int lineSpacing_px = static_cast<unsigned int>(std::lround(outlineSource.lineSpacing * scale));
+            if (outlineSource.used && lineSpacing_px > fontData.lineSpacing_px)
             {
-                unsigned int textureDataIndex = GetTextureIndex_H(
-                    i,
-                    0,
-                    textureData.width,
-                    j,
-                    0,
-                    textureData.height);
-
-                textureData.data[textureDataIndex] = 0;
-                textureData.data[textureDataIndex + 1] = 0;
-                textureData.data[textureDataIndex + 2] = 0;
-                textureData.data[textureDataIndex + 3] = 0;
+                fontData.lineSpacing_px = lineSpacing_px;
             }
         }
+        for (const auto& pair : glyphBitmapMap)
+        {
+            fontData.glyphMetricsMap[pair.first];
+        }
 
-        unsigned int nextCharacterOffsetX = 0;
-        unsigned int nextCharacterOffsetY = verticalSpacing;
+        return ComposeTextureData_H(
+            textureData,
+            fontData,
+            glyphBitmapMap,
+            horizontalSpacing,
+            verticalSpacing,
+            packOrder);
+    }
 
-        for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = glyphMetricsMap.begin(); iter != glyphMetricsMap.end(); ++iter)
+    bool CompareWithReferenceRasterizer(
+        RasterizerComparison& rasterizerComparison,
+        const OutlineCache& outlineCache,
+        const std::vector<FontSource>& fontSources,
+        unsigned int fontHeightInPixels,
+        unsigned int threadCount)
+    {
+        rasterizerComparison = RasterizerComparison();
+
+        auto nativeStart = std::chrono::steady_clock::now();
+        std::unordered_map<unsigned char, GlyphBitmap> glyphBitmapMap;
+        if (!RasterizeOutlineCache_H(glyphBitmapMap, outlineCache, fontHeightInPixels, threadCount))
         {
-            // left side spacing per glyph
-            for (unsigned int j = 0; j < textureData.height - verticalSpacing; ++j)
-            {
-                for (unsigned int i = 0; i < horizontalSpacing; ++i)
-                {
-                    unsigned int textureDataIndex = GetTextureIndex_H(
-                        i,
-                        nextCharacterOffsetX,
-                        textureData.width,
-                        j,
-                        nextCharacterOffsetY,
-                        textureData.height);
+            return false;
+        }
+        auto nativeEnd = std::chrono::steady_clock::now();
+        rasterizerComparison.nativeTime_ms = std::chrono::duration<double, std::milli>(nativeEnd - nativeStart).count();
 
-                    textureData.data[textureDataIndex] = 0;
-                    textureData.data[textureDataIndex + 1] = 0;
-                    textureData.data[textureDataIndex + 2] = 0;
-                    textureData.data[textureDataIndex + 3] = 0;
-                }
-            }
-            nextCharacterOffsetX += horizontalSpacing;
+        FT_Library library;
+        std::vector<FT_Face> faces;
+        if (!OpenFontSources_H(library, faces, fontSources))
+        {
+            return false;
+        }
 
-            const unsigned char& c = iter->first;
-            error = FT_Load_Char(face, c, FT_LOAD_RENDER);
+        for (FT_Face face : faces)
+        {
+            FT_Error error = FT_Set_Pixel_Sizes(face, 0, fontHeightInPixels);
             if (error)
             {
-                std::cerr << "ERROR: could not load character glyph for: " << c << std::endl;
+                std::cerr << "ERROR: could not set font pixel sizes" << std::endl;
+                CloseFontSources_H(library, faces);
                 return false;
             }
+        }
 
-            GlyphMetrics& glyphMetrics = iter->second;
-            glyphMetrics.height_px = face->glyph->bitmap.rows;
-            glyphMetrics.width_px = face->glyph->bitmap.width;
-            glyphMetrics.horiBearingX_px = face->glyph->metrics.horiBearingX / METRICS_UNIT_MULTIPLIER;
-            glyphMetrics.horiBearingY_px = face->glyph->metrics.horiBearingY / METRICS_UNIT_MULTIPLIER;
-            glyphMetrics.horiAdvance_px = face->glyph->metrics.horiAdvance / METRICS_UNIT_MULTIPLIER;
-            glyphMetrics.vertBearingX_px = face->glyph->metrics.vertBearingX / METRICS_UNIT_MULTIPLIER;
-            glyphMetrics.vertBearingY_px = face->glyph->metrics.vertBearingY / METRICS_UNIT_MULTIPLIER;
-            glyphMetrics.vertAdvance_px = face->glyph->metrics.vertAdvance / METRICS_UNIT_MULTIPLIER;
-            glyphMetrics.textureLeft = (float)nextCharacterOffsetX / (float)textureData.width;
-            glyphMetrics.textureRight = (float)(nextCharacterOffsetX + glyphMetrics.width_px) / (float)textureData.width;
-            if (s_textureCoordinatesFlippedVertically)
+        double referenceTime_ms = 0.0;
+        double differenceSum = 0.0;
+        size_t pixelCount = 0;
+        for (const auto& pair : glyphBitmapMap)
+        {
+            const unsigned char& c = pair.first;
+            const GlyphBitmap& glyphBitmap = pair.second;
+            FT_Face face = faces[glyphBitmap.sourceIndex];
+
+            // only rendering is timed, comparing isn't part of either rasterizer
+            auto referenceStart = std::chrono::steady_clock::now();
+            FT_Error error = FT_Load_Char(face, c, FT_LOAD_RENDER | FT_LOAD_NO_HINTING);
+            auto referenceEnd = std::chrono::steady_clock::now();
+            referenceTime_ms += std::chrono::duration<double, std::milli>(referenceEnd - referenceStart).count();
+            if (error)
             {
-                glyphMetrics.textureBottom = (float)(textureData.height - glyphMetrics.height_px - nextCharacterOffsetY) / (float)textureData.height;
-                glyphMetrics.textureTop = (float)(textureData.height - nextCharacterOffsetY) / (float)textureData.height;
+                std::cerr << "ERROR: could not load character glyph for: " << c << std::endl;
+                CloseFontSources_H(library, faces);
+                return false;
             }
-            else
+
+            const FT_Bitmap& bitmap = face->glyph->bitmap;
+            if (bitmap.pixel_mode != FT_Pixel_Mode::FT_PIXEL_MODE_GRAY)
             {
-                glyphMetrics.textureBottom = (float)(glyphMetrics.height_px + nextCharacterOffsetY) / (float)textureData.height;
-                glyphMetrics.textureTop = (float)(nextCharacterOffsetY) / (float)textureData.height;
+                std::cerr << "ERROR: glyph pixel mode not supported" << std::endl;
+                CloseFontSources_H(library, faces);
+                return false;
             }
 
-            for (unsigned int j = 0; j < glyphMetrics.height_px; ++j)
+            // compare over the union of both boxes, lined up on the glyph origin
+            const GlyphMetrics& glyphMetrics = glyphBitmap.metrics;
+            int nativeLeft = static_cast<int>(glyphMetrics.horiBearingX_px);
+            int nativeTop = static_cast<int>(glyphMetrics.horiBearingY_px);
+            int referenceLeft = face->glyph->bitmap_left;
+            int referenceTop = face->glyph->bitmap_top;
+            int left = std::min(nativeLeft, referenceLeft);
+            int right = std::max(nativeLeft + static_cast<int>(glyphMetrics.width_px), referenceLeft + static_cast<int>(bitmap.width));
+            int top = std::max(nativeTop, referenceTop);
+            int bottom = std::min(nativeTop - static_cast<int>(glyphMetrics.height_px), referenceTop - static_cast<int>(bitmap.rows));
+
+            for (int y = top; y > bottom; --y)
             {
-                for (unsigned int i = 0; i < glyphMetrics.width_px; ++i)
+                for (int x = left; x < right; ++x)
+                {
+                    int nativeX = x - nativeLeft;
+                    int nativeY = nativeTop - y;
+                    int nativeValue = 0;
+                    if (nativeX >= 0 && nativeX < static_cast<int>(glyphMetrics.width_px) &&
+                        nativeY >= 0 && nativeY < static_cast<int>(glyphMetrics.height_px))
+                    {
+                        nativeValue = glyphBitmap.coverage[nativeX + nativeY * glyphMetrics.width_px];
+                    }
+
+                    int referenceX = x - referenceLeft;
+                    int referenceY = referenceTop - y;
+                    int referenceValue = 0;
+                    if (referenceX >= 0 && referenceX < static_cast<int>(bitmap.width) &&
+                        referenceY >= 0 && referenceY < static_cast<int>(bitmap.rows))
+                    {
+                        referenceValue = bitmap.buffer[referenceX + referenceY * bitmap.pitch];
+                    }
+
+                    unsigned int difference = static_cast<unsigned int>(std::abs(nativeValue - referenceValue));
+                    if (difference > rasterizerComparison.maxDifference)
+                    {
+                        rasterizerComparison.maxDifference = difference;
+                        rasterizerComparison.maxDifferenceCharacter = c;
+                    }
+                    differenceSum += difference;
+                    ++pixelCount;
+                }
+            }
+        }
+
+        CloseFontSources_H(library, faces);
+
+        rasterizerComparison.glyphCount = static_cast<unsigned int>(glyphBitmapMap.size());
+        rasterizerComparison.meanDifference = pixelCount > 0 ? differenceSum / static_cast<double>(pixelCount) : 0.0;
+        rasterizerComparison.referenceTime_ms = referenceTime_ms;
+
+        return true;
+    }
+
+    bool LoadFontData(
+        FontData& fontData,
+        const std::vector<unsigned char>& characterList,
+        const std::string& filePath,
+        unsigned int fontHeightInPixels,
+        long faceIndex)
+    {
+        std::unordered_map<unsigned char, unsigned int> glyphSourceMap;
+        return LoadFontDataFromFontChain(
+            fontData,
+            glyphSourceMap,
+            characterList,
+            std::vector<FontSource>(1, FontSource(filePath, faceIndex)),
+            fontHeightInPixels
+        );
+    }
+
+    bool LoadFontDataFromFontChain(
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources,
+        unsigned int fontHeightInPixels)
+    {
+        FT_Library library;
+        std::vector<FT_Face> faces;
+        if (!OpenFontSources_H(library, faces, fontSources))
+        {
+            return false;
+        }
+
+        bool result = LoadFontData_H(
+            fontData,
+            glyphSourceMap,
+            characterList,
+            faces,
+            fontHeightInPixels
+        );
+
+        CloseFontSources_H(library, faces);
+
+        return result;
+    }
+
+    void PackFontData(
+        FontData& fontData,
+        unsigned int& textureWidth,
+        unsigned int& textureHeight,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        const std::vector<unsigned char>& packOrder)
+    {
+        std::unordered_map<unsigned char, unsigned int> glyphOffsetXMap;
+        PackFontData_H(
+            fontData,
+            glyphOffsetXMap,
+            textureWidth,
+            textureHeight,
+            horizontalSpacing,
+            verticalSpacing,
+            packOrder);
+    }
+
+    unsigned int GetTextureTopRow(
+        float textureBottom,
+        float textureTop,
+        unsigned int textureHeight)
+    {
+        // flipped coordinates count from the bottom edge, so the top row of
+        // the glyph is where the larger of the two lands counted from below
+        if (s_textureCoordinatesFlippedVertically)
+        {
+            long edge = std::lround(std::max(textureBottom, textureTop) * textureHeight);
+            return static_cast<unsigned int>(static_cast<long>(textureHeight) - edge);
+        }
+        return static_cast<unsigned int>(std::lround(std::min(textureBottom, textureTop) * textureHeight));
+    }
+
+    bool GetFaceCount(
+        long& faceCount,
+        const std::string& filePath)
+    {
+        FT_Library library;
+        FT_Error error = FT_Init_FreeType(&library);
+        if (error)
+        {
+            std::cerr << "ERROR: could not initalize the FreeType library" << std::endl;
+            return false;
+        }
+
+        // a negative face index only opens the file far enough to fill num_faces
+        FT_Face face;
+        error = FT_New_Face(library, filePath.c_str(), -1, &face);
+        if (error)
+        {
+            std::cerr << "ERROR: failed to load the font" << std::endl;
+            FT_Done_FreeType(library);
+            return false;
+        }
+
+        faceCount = face->num_faces;
+
+        FT_Done_Face(face);
+        FT_Done_FreeType(library);
+
+        return true;
+    }
+
+    bool WriteTextureData(
+        const TextureData& textureData,
+        const std::string& filePath)
+    {
+        std::vector<unsigned char> buffer;
+        if (!EncodeTextureData(buffer, textureData))
+        {
+            std::cerr << "Error: failed to save the texture" << std::endl;
+            return false;
+        }
+        return WriteFile_H(buffer.data(), buffer.size(), filePath);
+    }
+
+    bool EncodeTextureData(
+        std::vector<unsigned char>& buffer,
+        const TextureData& textureData)
+    {
+        if (textureData.data == nullptr || textureData.width == 0 || textureData.height == 0)
+        {
+            std::cerr << "Error: invalid texture data" << std::endl;
+            return false;
+        }
+
+        int stride_in_bytes = textureData.width * textureData.bytesPerPixel;
+        int success = stbi_write_png_to_func(
+            AppendPngData_H,           // appends every encoded chunk to the buffer
+            &buffer,
+            textureData.width,
+            textureData.height,
+            textureData.bytesPerPixel, // channels per pixel (e.g., 3 for RGB, 4 for RGBA)
+            textureData.data,          // pointer to the pixel data
+            stride_in_bytes            // stride (number of bytes per row)
+        );
+
+        if (success == 0)
+        {
+            std::cerr << "Error: failed to encode the texture" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool EncodeRawTextureData(
+        std::vector<unsigned char>& buffer,
+        const TextureData& textureData)
+    {
+        if (textureData.data == nullptr || textureData.width == 0 || textureData.height == 0)
+        {
+            std::cerr << "Error: invalid texture data" << std::endl;
+            return false;
+        }
+
+        buffer.reserve(buffer.size() + 24 + textureData.GetSize());
+
+        const char signature[] = "FSSTEXR";
+        AppendBytes_H(buffer, signature, 8); // ------------------------------------- 8 bytes
+        unsigned int version = 1;
+        AppendBytes_H(buffer, &version, 4); // -------------------------------------- 4 bytes
+
+        AppendBytes_H(buffer, &textureData.width, 4); // ---------------------------- 4 bytes
+        AppendBytes_H(buffer, &textureData.height, 4); // --------------------------- 4 bytes
+        AppendBytes_H(buffer, &textureData.bytesPerPixel, 4); // -------------------- 4 bytes
+
+        AppendBytes_H(buffer, textureData.data, textureData.GetSize()); // ---------- width * height * bytesPerPixel bytes
+
+        return true;
+    }
+
+    bool DecodeRawTextureData(
+        TextureData& textureData,
+        const unsigned char* dataPtr,
+        size_t dataSize)
+    {
+        if (dataSize < 24 || std::memcmp(dataPtr, "FSSTEXR", 8) != 0)
+        {
+            std::cerr << "ERROR: invalid texture data signature" << std::endl;
+            return false;
+        }
+
+        size_t offset = 8;
+        unsigned int version = 0;
+        ReadBytes_H(&version, dataPtr, offset, 4); // -------------------------------- 4 bytes
+        if (version != 1)
+        {
+            std::cerr << "ERROR: unsupported version" << std::endl;
+            return false;
+        }
+
+        unsigned int width = 0;
+        unsigned int height = 0;
+        unsigned int bytesPerPixel = 0;
+        ReadBytes_H(&width, dataPtr, offset, 4); // ---------------------------------- 4 bytes
+        ReadBytes_H(&height, dataPtr, offset, 4); // --------------------------------- 4 bytes
+        ReadBytes_H(&bytesPerPixel, dataPtr, offset, 4); // -------------------------- 4 bytes
+
+        size_t textureSize = static_cast<size_t>(width) * height * bytesPerPixel;
+        if (dataSize - offset < textureSize)
+        {
+            std::cerr << "ERROR: unexpected end of texture data" << std::endl;
+            return false;
+        }
+
+        if (!textureData.Allocate(width, height, bytesPerPixel))
+        {
+            std::cerr << "ERROR: memory allocation failed" << std::endl;
+            return false;
+        }
+        ReadBytes_H(textureData.data, dataPtr, offset, textureSize); // -------------- width * height * bytesPerPixel bytes
+
+        return true;
+    }
+
+    bool WriteFontData(
+        const FontData& fontData,
+        const std::string& filePath)
+    {
+        std::vector<unsigned char> buffer;
+        EncodeFontData(buffer, fontData);
+        return WriteFile_H(buffer.data(), buffer.size(), filePath);
+    }
+
+    void EncodeFontData(
+        std::vector<unsigned char>& buffer,
+        const FontData& fontData)
+    {
+        // version 3 is only needed for glyphs outside the alpha channel,
+        // version 4 only for subpixel variants
+        const bool hasSubpixelVariants = fontData.subpixelVariantCount > 1;
+        bool hasChannels = hasSubpixelVariants;
+        for (const auto& pair : fontData.glyphMetricsMap)
+        {
+            if (pair.second.channel != GlyphMetrics::ALPHA_CHANNEL)
+            {
+                hasChannels = true;
+                break;
+            }
+        }
+
+        const size_t glyphSize = (hasChannels ? 50 : 49) + (hasSubpixelVariants ? (fontData.subpixelVariantCount - 1) * 24 : 0);
+        buffer.reserve(buffer.size() + 24 + fontData.glyphMetricsMap.size() * glyphSize);
+
+        const char signature[] = "FSSDATA";
+        AppendBytes_H(buffer, signature, 8); // ------------------------------------------------- 8 bytes
+        unsigned int version = hasSubpixelVariants ? 4 : hasChannels ? 3 : 1;
+        AppendBytes_H(buffer, &version, 4); // -------------------------------------------------- 4 bytes
+
+        AppendBytes_H(buffer, &fontData.lineSpacing_px, 4); // ---------------------------------- 4 bytes
+        unsigned int glyphCount = fontData.glyphMetricsMap.size();
+        AppendBytes_H(buffer, &glyphCount, 4); // ----------------------------------------------- 4 bytes
+        if (hasSubpixelVariants)
+        {
+            AppendBytes_H(buffer, &fontData.subpixelVariantCount, 4); // ------------------------ 4 bytes
+        }
+
+        for (const auto& pair : fontData.glyphMetricsMap) {
+            unsigned char glyph = pair.first;
+            AppendBytes_H(buffer, &glyph, 1); // ------------------------------------------------ 1 byte
+
+            const GlyphMetrics& metrics = pair.second;
+            AppendBytes_H(buffer, &metrics.width_px, 4); // ------------------------------------- 4 bytes
+            AppendBytes_H(buffer, &metrics.height_px, 4); // ------------------------------------ 4 bytes
+            AppendBytes_H(buffer, &metrics.horiBearingX_px, 4); // ------------------------------ 4 bytes
+            AppendBytes_H(buffer, &metrics.horiBearingY_px, 4); // ------------------------------ 4 bytes
+            AppendBytes_H(buffer, &metrics.horiAdvance_px, 4); // ------------------------------- 4 bytes
+            AppendBytes_H(buffer, &metrics.vertBearingX_px, 4); // ------------------------------ 4 bytes
+            AppendBytes_H(buffer, &metrics.vertBearingY_px, 4); // ------------------------------ 4 bytes
+            AppendBytes_H(buffer, &metrics.vertAdvance_px, 4); // ------------------------------- 4 bytes
+
+            AppendBytes_H(buffer, &metrics.textureLeft, 4); // ---------------------------------- 4 bytes
+            AppendBytes_H(buffer, &metrics.textureRight, 4); // --------------------------------- 4 bytes
+            AppendBytes_H(buffer, &metrics.textureBottom, 4); // -------------------------------- 4 bytes
+            AppendBytes_H(buffer, &metrics.textureTop, 4); // ----------------------------------- 4 bytes
+
+            if (hasChannels)
+            {
+                AppendBytes_H(buffer, &metrics.channel, 1); // ---------------------------------- 1 byte
+            }
+
+            if (hasSubpixelVariants)
+            {
+                // a glyph without variants gets empty ones, the count is per font
+                auto variants = fontData.subpixelVariantMap.find(glyph);
+                for (unsigned int i = 0; i < fontData.subpixelVariantCount - 1; ++i)
+                {
+                    SubpixelVariant subpixelVariant;
+                    if (variants != fontData.subpixelVariantMap.end() && i < variants->second.size())
+                    {
+                        subpixelVariant = variants->second[i];
+                    }
+                    AppendBytes_H(buffer, &subpixelVariant.width_px, 4); // ------------------------ 4 bytes
+                    AppendBytes_H(buffer, &subpixelVariant.horiBearingX_px, 4); // ----------------- 4 bytes
+                    AppendBytes_H(buffer, &subpixelVariant.textureLeft, 4); // --------------------- 4 bytes
+                    AppendBytes_H(buffer, &subpixelVariant.textureRight, 4); // -------------------- 4 bytes
+                    AppendBytes_H(buffer, &subpixelVariant.textureBottom, 4); // ------------------- 4 bytes
+                    AppendBytes_H(buffer, &subpixelVariant.textureTop, 4); // ---------------------- 4 bytes
+                }
+            }
+        }
+    }
+
+    bool WriteFontDataHeader(
+        const FontData& fontData,
+        const TextureData& textureData,
+        const std::string& filePath,
+        const std::string& namespaceName)
+    {
+        if (namespaceName.empty() ||
+            namespaceName.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_") != std::string::npos ||
+            (namespaceName[0] >= '0' && namespaceName[0] <= '9'))
+        {
+            std::cerr << "ERROR: invalid namespace name: " << namespaceName << std::endl;
+            return false;
+        }
+
+        std::ostringstream fileStream;
+
+        // sorted so the lookup can be a binary search
+        std::vector<unsigned char> characters;
+        characters.reserve(fontData.glyphMetricsMap.size());
+        for (const auto& pair : fontData.glyphMetricsMap)
+        {
+            characters.push_back(pair.first);
+        }
+        std::sort(characters.begin(), characters.end());
+
+        bool hasTexture = textureData.data != nullptr && textureData.width != 0 && textureData.height != 0;
+
+        fileStream << "// Generated by FontToSpriteSheet, do not edit.\n";
+        fileStream << "//\n";
+        fileStream << "// Requires C++14. The arrays have internal linkage, include this header in\n";
+        fileStream << "// a single translation unit to keep one copy of the texture in the program.\n";
+        fileStream << "\n";
+        fileStream << "#pragma once\n";
+        fileStream << "\n";
+        fileStream << "namespace " << namespaceName << "\n";
+        fileStream << "{\n";
+        fileStream << "    struct GlyphMetrics\n";
+        fileStream << "    {\n";
+        fileStream << "        unsigned char character;\n";
+        fileStream << "\n";
+        fileStream << "        unsigned int width_px;\n";
+        fileStream << "        unsigned int height_px;\n";
+        fileStream << "        unsigned int horiBearingX_px;\n";
+        fileStream << "        unsigned int horiBearingY_px;\n";
+        fileStream << "        unsigned int horiAdvance_px;\n";
+        fileStream << "        unsigned int vertBearingX_px;\n";
+        fileStream << "        unsigned int vertBearingY_px;\n";
+        fileStream << "        unsigned int vertAdvance_px;\n";
+        fileStream << "\n";
+        fileStream << "        float textureLeft;\n";
+        fileStream << "        float textureRight;\n";
+        fileStream << "        float textureBottom;\n";
+        fileStream << "        float textureTop;\n";
+        fileStream << "\n";
+        fileStream << "        unsigned char channel; // 0 to 3 for R, G, B and A\n";
+        fileStream << "    };\n";
+        fileStream << "\n";
+        if (fontData.subpixelVariantCount > 1)
+        {
+            fileStream << "    // variant i of a glyph is shifted right by i / SUBPIXEL_VARIANT_COUNT pixels,\n";
+            fileStream << "    // variant 0 is the glyph itself\n";
+            fileStream << "    struct SubpixelVariant\n";
+            fileStream << "    {\n";
+            fileStream << "        unsigned int width_px;\n";
+            fileStream << "        unsigned int horiBearingX_px;\n";
+            fileStream << "\n";
+            fileStream << "        float textureLeft;\n";
+            fileStream << "        float textureRight;\n";
+            fileStream << "        float textureBottom;\n";
+            fileStream << "        float textureTop;\n";
+            fileStream << "    };\n";
+            fileStream << "\n";
+        }
+        fileStream << "    constexpr unsigned int LINE_SPACING_PX = " << fontData.lineSpacing_px << "u;\n";
+        fileStream << "    constexpr unsigned int GLYPH_COUNT = " << characters.size() << "u;\n";
+        fileStream << "    constexpr unsigned int SUBPIXEL_VARIANT_COUNT = " << fontData.subpixelVariantCount << "u;\n";
+        fileStream << "\n";
+
+        if (characters.empty())
+        {
+            // zero sized arrays aren't allowed, keep one entry nothing can find
+            fileStream << "    constexpr GlyphMetrics GLYPH_METRICS[1] = { {} };\n";
+        }
+        else
+        {
+            fileStream << "    constexpr GlyphMetrics GLYPH_METRICS[GLYPH_COUNT] =\n";
+            fileStream << "    {\n";
+
+            // 9 significant digits are enough for every float to read back exactly
+            fileStream << std::scientific << std::setprecision(8);
+            for (unsigned char c : characters)
+            {
+                const GlyphMetrics& metrics = fontData.glyphMetricsMap.at(c);
+                fileStream << "        { " << static_cast<unsigned int>(c) << "u, ";
+                fileStream << metrics.width_px << "u, ";
+                fileStream << metrics.height_px << "u, ";
+                fileStream << metrics.horiBearingX_px << "u, ";
+                fileStream << metrics.horiBearingY_px << "u, ";
+                fileStream << metrics.horiAdvance_px << "u, ";
+                fileStream << metrics.vertBearingX_px << "u, ";
+                fileStream << metrics.vertBearingY_px << "u, ";
+                fileStream << metrics.vertAdvance_px << "u, ";
+                fileStream << metrics.textureLeft << "f, ";
+                fileStream << metrics.textureRight << "f, ";
+                fileStream << metrics.textureBottom << "f, ";
+                fileStream << metrics.textureTop << "f, ";
+                fileStream << static_cast<unsigned int>(metrics.channel) << "u },";
+                if (c > 32 && c < 127)
+                {
+                    fileStream << " // '" << static_cast<char>(c) << "'";
+                }
+                fileStream << "\n";
+            }
+            fileStream << std::defaultfloat;
+
+            fileStream << "    };\n";
+        }
+
+        if (fontData.subpixelVariantCount > 1)
+        {
+            // same order as GLYPH_METRICS, so the index FindGlyphMetrics finds works here too
+            fileStream << "\n";
+            if (characters.empty())
+            {
+                fileStream << "    constexpr SubpixelVariant SUBPIXEL_VARIANTS[1][SUBPIXEL_VARIANT_COUNT - 1] = { {} };\n";
+            }
+            else
+            {
+                fileStream << "    constexpr SubpixelVariant SUBPIXEL_VARIANTS[GLYPH_COUNT][SUBPIXEL_VARIANT_COUNT - 1] =\n";
+                fileStream << "    {\n";
+
+                fileStream << std::scientific << std::setprecision(8);
+                for (unsigned char c : characters)
+                {
+                    fileStream << "        {";
+                    auto variants = fontData.subpixelVariantMap.find(c);
+                    for (unsigned int i = 0; i < fontData.subpixelVariantCount - 1; ++i)
+                    {
+                        SubpixelVariant subpixelVariant;
+                        if (variants != fontData.subpixelVariantMap.end() && i < variants->second.size())
+                        {
+                            subpixelVariant = variants->second[i];
+                        }
+                        fileStream << " { " << subpixelVariant.width_px << "u, ";
+                        fileStream << subpixelVariant.horiBearingX_px << "u, ";
+                        fileStream << subpixelVariant.textureLeft << "f, ";
+                        fileStream << subpixelVariant.textureRight << "f, ";
+                        fileStream << subpixelVariant.textureBottom << "f, ";
+                        fileStream << subpixelVariant.textureTop << "f },";
+                    }
+                    fileStream << " },";
+                    if (c > 32 && c < 127)
+                    {
+                        fileStream << " // '" << static_cast<char>(c) << "'";
+                    }
+                    fileStream << "\n";
+                }
+                fileStream << std::defaultfloat;
+
+                fileStream << "    };\n";
+            }
+        }
+
+        fileStream << "\n";
+        fileStream << "    // nullptr if there is no glyph for the character\n";
+        fileStream << "    constexpr const GlyphMetrics* FindGlyphMetrics(unsigned char character)\n";
+        fileStream << "    {\n";
+        fileStream << "        unsigned int first = 0;\n";
+        fileStream << "        unsigned int last = GLYPH_COUNT;\n";
+        fileStream << "        while (first < last)\n";
+        fileStream << "        {\n";
+        fileStream << "            unsigned int middle = first + (last - first) / 2;\n";
+        fileStream << "            if (GLYPH_METRICS[middle].character < character)\n";
+        fileStream << "            {\n";
+        fileStream << "                first = middle + 1;\n";
+        fileStream << "            }\n";
+        fileStream << "            else\n";
+        fileStream << "            {\n";
+        fileStream << "                last = middle;\n";
+        fileStream << "            }\n";
+        fileStream << "        }\n";
+        fileStream << "        if (first < GLYPH_COUNT && GLYPH_METRICS[first].character == character)\n";
+        fileStream << "        {\n";
+        fileStream << "            return &GLYPH_METRICS[first];\n";
+        fileStream << "        }\n";
+        fileStream << "        return nullptr;\n";
+        fileStream << "    }\n";
+        fileStream << "\n";
+
+        if (hasTexture)
+        {
+            size_t textureSize = static_cast<size_t>(textureData.width) * textureData.height * textureData.bytesPerPixel;
+
+            fileStream << "    constexpr unsigned int TEXTURE_WIDTH = " << textureData.width << "u;\n";
+            fileStream << "    constexpr unsigned int TEXTURE_HEIGHT = " << textureData.height << "u;\n";
+            fileStream << "    constexpr unsigned int TEXTURE_BYTES_PER_PIXEL = " << textureData.bytesPerPixel << "u;\n";
+            fileStream << "\n";
+            fileStream << "    alignas(16) constexpr unsigned char TEXTURE_DATA[" << textureSize << "] =\n";
+            fileStream << "    {";
+            for (size_t i = 0; i < textureSize; ++i)
+            {
+                if (i % 32 == 0)
+                {
+                    fileStream << "\n        ";
+                }
+                fileStream << static_cast<unsigned int>(textureData.data[i]) << ",";
+            }
+            fileStream << "\n    };\n";
+        }
+        else
+        {
+            fileStream << "    constexpr unsigned int TEXTURE_WIDTH = 0u;\n";
+            fileStream << "    constexpr unsigned int TEXTURE_HEIGHT = 0u;\n";
+            fileStream << "    constexpr unsigned int TEXTURE_BYTES_PER_PIXEL = 0u;\n";
+        }
+
+        fileStream << "}\n";
+
+        const std::string text = fileStream.str();
+        return WriteFile_H(reinterpret_cast<const unsigned char*>(text.data()), text.size(), filePath);
+    }
+
+    bool ReadFontData(
+        FontData& fontData,
+        const std::string& filePath)
+    {
+        std::vector<unsigned char> buffer;
+        if (!ReadFile_H(buffer, filePath))
+        {
+            return false;
+        }
+        return DecodeFontData(fontData, buffer.data(), buffer.size());
+    }
+
+    bool DecodeFontData(
+        FontData& fontData,
+        const unsigned char* dataPtr,
+        size_t dataSize)
+    {
+        size_t offset = 0;
+        unsigned int version = 0;
+        if (!DecodeFontDataHeader_H(version, dataPtr, dataSize, offset))
+        {
+            return false;
+        }
+
+        if (version != 2)
+        {
+            return DecodeFontDataBody_H(fontData, version, dataPtr, dataSize, offset);
+        }
+
+        CompactFontData compactFontData;
+        if (!DecodeCompactFontDataBody_H(compactFontData, dataPtr, dataSize, offset))
+        {
+            return false;
+        }
+        ConvertFromCompactFontData(fontData, compactFontData);
+        return true;
+    }
+
+    bool ConvertToCompactFontData(
+        CompactFontData& compactFontData,
+        const FontData& fontData)
+    {
+        const unsigned int UNSIGNED_MAX = 0xFFFF;
+        const int SIGNED_MIN = -0x8000;
+        const int SIGNED_MAX = 0x7FFF;
+        const float NORMALIZED_MAX = 65535.0f;
+
+        if (fontData.lineSpacing_px > UNSIGNED_MAX)
+        {
+            std::cerr << "ERROR: line spacing doesn't fit into 16 bits" << std::endl;
+            return false;
+        }
+
+        if (fontData.subpixelVariantCount > 1)
+        {
+            std::cerr << "ERROR: compact font data has no subpixel variants" << std::endl;
+            return false;
+        }
+
+        compactFontData.Clear();
+        compactFontData.lineSpacing_px = static_cast<unsigned short>(fontData.lineSpacing_px);
+
+        // slots in character order so the same font data always compacts the same way
+        for (unsigned int c = 0; c < 256; ++c)
+        {
+            if (fontData.glyphMetricsMap.find(static_cast<unsigned char>(c)) != fontData.glyphMetricsMap.end())
+            {
+                compactFontData.slotMap[c] = static_cast<unsigned short>(compactFontData.characters.size());
+                compactFontData.characters.push_back(static_cast<unsigned char>(c));
+            }
+        }
+
+        size_t glyphCount = compactFontData.characters.size();
+        compactFontData.width_px.resize(glyphCount);
+        compactFontData.height_px.resize(glyphCount);
+        compactFontData.horiBearingX_px.resize(glyphCount);
+        compactFontData.horiBearingY_px.resize(glyphCount);
+        compactFontData.horiAdvance_px.resize(glyphCount);
+        compactFontData.vertBearingX_px.resize(glyphCount);
+        compactFontData.vertBearingY_px.resize(glyphCount);
+        compactFontData.vertAdvance_px.resize(glyphCount);
+        compactFontData.textureLeft.resize(glyphCount);
+        compactFontData.textureRight.resize(glyphCount);
+        compactFontData.textureBottom.resize(glyphCount);
+        compactFontData.textureTop.resize(glyphCount);
+
+        for (size_t slot = 0; slot < glyphCount; ++slot)
+        {
+            const unsigned char c = compactFontData.characters[slot];
+            const GlyphMetrics& metrics = fontData.glyphMetricsMap.at(c);
+
+            if (metrics.channel != GlyphMetrics::ALPHA_CHANNEL)
+            {
+                std::cerr << "ERROR: compact font data has no channels, glyph isn't in the alpha channel: " << c << std::endl;
+                return false;
+            }
+
+            // bearings can be negative, they are stored two's complement in the unsigned fields
+            const unsigned int unsignedValues[] = {
+                metrics.width_px,
+                metrics.height_px,
+                metrics.horiAdvance_px,
+                metrics.vertAdvance_px };
+            const int signedValues[] = {
+                static_cast<int>(metrics.horiBearingX_px),
+                static_cast<int>(metrics.horiBearingY_px),
+                static_cast<int>(metrics.vertBearingX_px),
+                static_cast<int>(metrics.vertBearingY_px) };
+            for (unsigned int value : unsignedValues)
+            {
+                if (value > UNSIGNED_MAX)
+                {
+                    std::cerr << "ERROR: glyph metrics don't fit into 16 bits for: " << c << std::endl;
+                    return false;
+                }
+            }
+            for (int value : signedValues)
+            {
+                if (value < SIGNED_MIN || value > SIGNED_MAX)
+                {
+                    std::cerr << "ERROR: glyph metrics don't fit into 16 bits for: " << c << std::endl;
+                    return false;
+                }
+            }
+
+            compactFontData.width_px[slot] = static_cast<unsigned short>(metrics.width_px);
+            compactFontData.height_px[slot] = static_cast<unsigned short>(metrics.height_px);
+            compactFontData.horiBearingX_px[slot] = static_cast<short>(signedValues[0]);
+            compactFontData.horiBearingY_px[slot] = static_cast<short>(signedValues[1]);
+            compactFontData.horiAdvance_px[slot] = static_cast<unsigned short>(metrics.horiAdvance_px);
+            compactFontData.vertBearingX_px[slot] = static_cast<short>(signedValues[2]);
+            compactFontData.vertBearingY_px[slot] = static_cast<short>(signedValues[3]);
+            compactFontData.vertAdvance_px[slot] = static_cast<unsigned short>(metrics.vertAdvance_px);
+
+            const float textureCoordinates[] = {
+                metrics.textureLeft,
+                metrics.textureRight,
+                metrics.textureBottom,
+                metrics.textureTop };
+            unsigned short normalizedCoordinates[4];
+            for (unsigned int i = 0; i < 4; ++i)
+            {
+                float value = textureCoordinates[i] < 0.0f ? 0.0f : (textureCoordinates[i] > 1.0f ? 1.0f : textureCoordinates[i]);
+                normalizedCoordinates[i] = static_cast<unsigned short>(value * NORMALIZED_MAX + 0.5f);
+            }
+            compactFontData.textureLeft[slot] = normalizedCoordinates[0];
+            compactFontData.textureRight[slot] = normalizedCoordinates[1];
+            compactFontData.textureBottom[slot] = normalizedCoordinates[2];
+            compactFontData.textureTop[slot] = normalizedCoordinates[3];
+        }
+
+        return true;
+    }
+
+    void ConvertFromCompactFontData(
+        FontData& fontData,
+        const CompactFontData& compactFontData)
+    {
+        const float NORMALIZED_MAX = 65535.0f;
+
+        fontData.lineSpacing_px = compactFontData.lineSpacing_px;
+        fontData.subpixelVariantCount = 1;
+        fontData.subpixelVariantMap.clear();
+
+        for (size_t slot = 0; slot < compactFontData.GetGlyphCount(); ++slot)
+        {
+            GlyphMetrics& metrics = fontData.glyphMetricsMap[compactFontData.characters[slot]];
+            metrics.width_px = compactFontData.width_px[slot];
+            metrics.height_px = compactFontData.height_px[slot];
+            metrics.horiBearingX_px = static_cast<unsigned int>(static_cast<int>(compactFontData.horiBearingX_px[slot]));
+            metrics.horiBearingY_px = static_cast<unsigned int>(static_cast<int>(compactFontData.horiBearingY_px[slot]));
+            metrics.horiAdvance_px = compactFontData.horiAdvance_px[slot];
+            metrics.vertBearingX_px = static_cast<unsigned int>(static_cast<int>(compactFontData.vertBearingX_px[slot]));
+            metrics.vertBearingY_px = static_cast<unsigned int>(static_cast<int>(compactFontData.vertBearingY_px[slot]));
+            metrics.vertAdvance_px = compactFontData.vertAdvance_px[slot];
+            metrics.textureLeft = compactFontData.textureLeft[slot] / NORMALIZED_MAX;
+            metrics.textureRight = compactFontData.textureRight[slot] / NORMALIZED_MAX;
+            metrics.textureBottom = compactFontData.textureBottom[slot] / NORMALIZED_MAX;
+            metrics.textureTop = compactFontData.textureTop[slot] / NORMALIZED_MAX;
+            metrics.channel = GlyphMetrics::ALPHA_CHANNEL;
+        }
+    }
+
+    bool WriteCompactFontData(
+        const CompactFontData& compactFontData,
+        const std::string& filePath)
+    {
+        std::vector<unsigned char> buffer;
+        EncodeCompactFontData(buffer, compactFontData);
+        return WriteFile_H(buffer.data(), buffer.size(), filePath);
+    }
+
+    void EncodeCompactFontData(
+        std::vector<unsigned char>& buffer,
+        const CompactFontData& compactFontData)
+    {
+        unsigned short glyphCount = static_cast<unsigned short>(compactFontData.GetGlyphCount());
+        buffer.reserve(buffer.size() + 16 + glyphCount * 25);
+
+        const char signature[] = "FSSDATA";
+        AppendBytes_H(buffer, signature, 8); // ------------------------------------------------- 8 bytes
+        unsigned int version = 2;
+        AppendBytes_H(buffer, &version, 4); // -------------------------------------------------- 4 bytes
+
+        AppendBytes_H(buffer, &compactFontData.lineSpacing_px, 2); // --------------------------- 2 bytes
+        AppendBytes_H(buffer, &glyphCount, 2); // ----------------------------------------------- 2 bytes
+
+        // one array per metric, each glyphCount long, in slot order
+        AppendBytes_H(buffer, compactFontData.characters.data(), glyphCount); // ---------------- 1 byte each
+        AppendBytes_H(buffer, compactFontData.width_px.data(), glyphCount * 2); // -------------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.height_px.data(), glyphCount * 2); // ------------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.horiBearingX_px.data(), glyphCount * 2); // ------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.horiBearingY_px.data(), glyphCount * 2); // ------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.horiAdvance_px.data(), glyphCount * 2); // -------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.vertBearingX_px.data(), glyphCount * 2); // ------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.vertBearingY_px.data(), glyphCount * 2); // ------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.vertAdvance_px.data(), glyphCount * 2); // -------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.textureLeft.data(), glyphCount * 2); // ----------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.textureRight.data(), glyphCount * 2); // ---------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.textureBottom.data(), glyphCount * 2); // --------- 2 bytes each
+        AppendBytes_H(buffer, compactFontData.textureTop.data(), glyphCount * 2); // ------------ 2 bytes each
+    }
+
+    bool ReadCompactFontData(
+        CompactFontData& compactFontData,
+        const std::string& filePath)
+    {
+        std::vector<unsigned char> buffer;
+        if (!ReadFile_H(buffer, filePath))
+        {
+            return false;
+        }
+        return DecodeCompactFontData(compactFontData, buffer.data(), buffer.size());
+    }
+
+    bool DecodeCompactFontData(
+        CompactFontData& compactFontData,
+        const unsigned char* dataPtr,
+        size_t dataSize)
+    {
+        size_t offset = 0;
+        unsigned int version = 0;
+        if (!DecodeFontDataHeader_H(version, dataPtr, dataSize, offset))
+        {
+            return false;
+        }
+
+        if (version == 2)
+        {
+            return DecodeCompactFontDataBody_H(compactFontData, dataPtr, dataSize, offset);
+        }
+
+        FontData fontData;
+        return DecodeFontDataBody_H(fontData, version, dataPtr, dataSize, offset) &&
+            ConvertToCompactFontData(compactFontData, fontData);
+    }
+
+    // protected ---------------------------------------------------------------
+
+    bool LoadTextureDataAndFontData_H(
+        TextureData& textureData,
+        FontData& fontData,
+        const std::vector<unsigned char>& characterList,
+        FT_Face face,
+        unsigned int fontHeightInPixels,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing)
+    {
+        std::unordered_map<unsigned char, unsigned int> glyphSourceMap;
+        return LoadTextureDataAndFontData_H(
+            textureData,
+            fontData,
+            glyphSourceMap,
+            characterList,
+            std::vector<FT_Face>(1, face),
+            fontHeightInPixels,
+            horizontalSpacing,
+            verticalSpacing
+        );
+    }
+
+    bool LoadTextureDataAndFontData_H(
+        TextureData& textureData,
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        unsigned int subpixelVariantCount,
+        const std::vector<unsigned char>& packOrder)
+    {
+        GlyphCache glyphCache;
+        return LoadTextureDataAndFontData_H(
+            textureData,
+            fontData,
+            glyphCache,
+            glyphSourceMap,
+            characterList,
+            faces,
+            fontHeightInPixels,
+            horizontalSpacing,
+            verticalSpacing,
+            subpixelVariantCount,
+            packOrder
+        );
+    }
+
+    bool LoadTextureDataAndFontData_H(
+        TextureData& textureData,
+        FontData& fontData,
+        GlyphCache& glyphCache,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        unsigned int subpixelVariantCount,
+        const std::vector<unsigned char>& packOrder)
+    {
+        if (!RenderGlyphBitmaps_H(fontData, glyphCache, glyphSourceMap, characterList, faces, fontHeightInPixels, subpixelVariantCount))
+        {
+            return false;
+        }
+
+        return ComposeTextureData_H(
+            textureData,
+            fontData,
+            glyphCache.glyphBitmapMap,
+            horizontalSpacing,
+            verticalSpacing,
+            packOrder);
+    }
+
+    bool RenderGlyphBitmaps_H(
+        FontData& fontData,
+        GlyphCache& glyphCache,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels,
+        unsigned int subpixelVariantCount)
+    {
+        if (subpixelVariantCount == 0 || subpixelVariantCount > FontData::MAX_SUBPIXEL_VARIANT_COUNT)
+        {
+            std::cerr << "ERROR: subpixel variant count must be 1 to " << FontData::MAX_SUBPIXEL_VARIANT_COUNT << std::endl;
+            return false;
+        }
+
+        if (!PrepareFontData_H(fontData, glyphSourceMap, characterList, faces, fontHeightInPixels))
+        {
+            return false;
+        }
+
+        if (glyphCache.fontHeightInPixels != fontHeightInPixels || glyphCache.subpixelVariantCount != subpixelVariantCount)
+        {
+            glyphCache.Clear();
+            glyphCache.fontHeightInPixels = fontHeightInPixels;
+            glyphCache.subpixelVariantCount = subpixelVariantCount;
+        }
+
+        // forget glyphs that aren't needed anymore or now come from another face
+        std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap = glyphCache.glyphBitmapMap;
+        for (std::unordered_map<unsigned char, GlyphBitmap>::iterator iter = glyphBitmapMap.begin(); iter != glyphBitmapMap.end();)
+        {
+            std::unordered_map<unsigned char, unsigned int>::const_iterator source = glyphSourceMap.find(iter->first);
+            if (source == glyphSourceMap.end() || source->second != iter->second.sourceIndex)
+            {
+                iter = glyphBitmapMap.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        glyphCache.renderedGlyphCount = 0;
+        for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = fontData.glyphMetricsMap.begin(); iter != fontData.glyphMetricsMap.end(); ++iter)
+        {
+            const unsigned char& c = iter->first;
+            if (glyphBitmapMap.find(c) != glyphBitmapMap.end())
+            {
+                continue;
+            }
+
+            unsigned int sourceIndex = glyphSourceMap[c];
+            GlyphBitmap& glyphBitmap = glyphBitmapMap[c];
+            bool rendered = RenderGlyphBitmap_H(glyphBitmap, faces[sourceIndex], c);
+
+            glyphBitmap.subpixelBitmaps.resize(subpixelVariantCount - 1);
+            for (unsigned int i = 1; rendered && i < subpixelVariantCount; ++i)
+            {
+                // to the nearest 1/64 pixel FreeType can translate by
+                long offsetX = static_cast<long>((i * METRICS_UNIT_MULTIPLIER + subpixelVariantCount / 2) / subpixelVariantCount);
+                SubpixelBitmap& subpixelBitmap = glyphBitmap.subpixelBitmaps[i - 1];
+                rendered = RenderSubpixelBitmap_H(subpixelBitmap, faces[sourceIndex], c, offsetX);
+                if (rendered && subpixelBitmap.coverage.size() != static_cast<size_t>(subpixelBitmap.width_px) * glyphBitmap.metrics.height_px)
+                {
+                    std::cerr << "ERROR: subpixel variant height differs for: " << c << std::endl;
+                    rendered = false;
+                }
+            }
+
+            if (!rendered)
+            {
+                glyphBitmapMap.erase(c);
+                return false;
+            }
+            glyphBitmap.sourceIndex = sourceIndex;
+            ++glyphCache.renderedGlyphCount;
+        }
+
+        return true;
+    }
+
+    bool RenderGlyphBitmap_H(
+        GlyphBitmap& glyphBitmap,
+        FT_Face face,
+        unsigned char character)
+    {
+        FT_Error error = FT_Load_Char(face, character, FT_LOAD_RENDER);
+        if (error)
+        {
+            std::cerr << "ERROR: could not load character glyph for: " << character << std::endl;
+            return false;
+        }
+
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        if (bitmap.pixel_mode != FT_Pixel_Mode::FT_PIXEL_MODE_GRAY)
+        {
+            std::cerr << "ERROR: glyph pixel mode not supported" << std::endl;
+            return false;
+        }
+
+        GlyphMetrics& glyphMetrics = glyphBitmap.metrics;
+        SetGlyphMetrics_H(glyphMetrics, face->glyph);
+
+        glyphBitmap.coverage.resize(static_cast<size_t>(glyphMetrics.width_px) * glyphMetrics.height_px);
+        for (unsigned int j = 0; j < glyphMetrics.height_px; ++j)
+        {
+            std::memcpy(
+                glyphBitmap.coverage.data() + j * glyphMetrics.width_px,
+                bitmap.buffer + j * bitmap.pitch,
+                glyphMetrics.width_px);
+        }
+
+        return true;
+    }
+
+    bool RenderSubpixelBitmap_H(
+        SubpixelBitmap& subpixelBitmap,
+        FT_Face face,
+        unsigned char character,
+        long offsetX)
+    {
+        // same hinting as FT_LOAD_RENDER, the outline is moved afterwards
+        FT_Error error = FT_Load_Char(face, character, FT_LOAD_DEFAULT);
+        if (error)
+        {
+            std::cerr << "ERROR: could not load character glyph for: " << character << std::endl;
+            return false;
+        }
+
+        // embedded bitmaps can't be moved, every variant is the same then
+        FT_GlyphSlot glyph = face->glyph;
+        if (glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+        {
+            FT_Outline_Translate(&glyph->outline, offsetX, 0);
+        }
+
+        error = FT_Render_Glyph(glyph, FT_RENDER_MODE_NORMAL);
+        if (error)
+        {
+            std::cerr << "ERROR: could not render character glyph for: " << character << std::endl;
+            return false;
+        }
+
+        const FT_Bitmap& bitmap = glyph->bitmap;
+        if (bitmap.pixel_mode != FT_Pixel_Mode::FT_PIXEL_MODE_GRAY)
+        {
+            std::cerr << "ERROR: glyph pixel mode not supported" << std::endl;
+            return false;
+        }
+
+        subpixelBitmap.width_px = bitmap.width;
+        subpixelBitmap.horiBearingX_px = static_cast<unsigned int>(glyph->bitmap_left);
+        subpixelBitmap.coverage.resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+        for (unsigned int j = 0; j < bitmap.rows; ++j)
+        {
+            std::memcpy(
+                subpixelBitmap.coverage.data() + j * bitmap.width,
+                bitmap.buffer + j * bitmap.pitch,
+                bitmap.width);
+        }
+
+        return true;
+    }
+
+    bool ComposeTextureData_H(
+        TextureData& textureData,
+        FontData& fontData,
+        const std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        const std::vector<unsigned char>& packOrder)
+    {
+        std::unordered_map<unsigned char, GlyphMetrics>& glyphMetricsMap = fontData.glyphMetricsMap;
+        fontData.subpixelVariantCount = 1;
+        fontData.subpixelVariantMap.clear();
+        for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = glyphMetricsMap.begin(); iter != glyphMetricsMap.end(); ++iter)
+        {
+            const GlyphBitmap& glyphBitmap = glyphBitmapMap.at(iter->first);
+            iter->second = glyphBitmap.metrics;
+
+            if (!glyphBitmap.subpixelBitmaps.empty())
+            {
+                fontData.subpixelVariantCount = static_cast<unsigned int>(glyphBitmap.subpixelBitmaps.size()) + 1;
+                std::vector<SubpixelVariant>& subpixelVariants = fontData.subpixelVariantMap[iter->first];
+                subpixelVariants.resize(glyphBitmap.subpixelBitmaps.size());
+                for (size_t i = 0; i < subpixelVariants.size(); ++i)
+                {
+                    subpixelVariants[i].width_px = glyphBitmap.subpixelBitmaps[i].width_px;
+                    subpixelVariants[i].horiBearingX_px = glyphBitmap.subpixelBitmaps[i].horiBearingX_px;
+                }
+            }
+        }
+
+        std::unordered_map<unsigned char, unsigned int> glyphOffsetXMap;
+        unsigned int textureWidth;
+        unsigned int textureHeight;
+        PackFontData_H(
+            fontData,
+            glyphOffsetXMap,
+            textureWidth,
+            textureHeight,
+            horizontalSpacing,
+            verticalSpacing,
+            packOrder);
+
+        if (!textureData.Allocate(textureWidth, textureHeight, 4))
+        {
+            std::cerr << "ERROR: memory allocation failed" << std::endl;
+            return false;
+        }
+
+        // every pixel outside of a glyph is spacing
+        std::memset(textureData.data, 0, textureData.GetSize());
+
+        for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = glyphMetricsMap.begin(); iter != glyphMetricsMap.end(); ++iter)
+        {
+            const GlyphMetrics& glyphMetrics = iter->second;
+            const GlyphBitmap& glyphBitmap = glyphBitmapMap.at(iter->first);
+            unsigned int offsetX = glyphOffsetXMap[iter->first];
+
+            // the glyph and then its subpixel variants, as PackFontData_H placed them
+            for (size_t variant = 0; variant <= glyphBitmap.subpixelBitmaps.size(); ++variant)
+            {
+                unsigned int width_px = variant == 0 ? glyphMetrics.width_px : glyphBitmap.subpixelBitmaps[variant - 1].width_px;
+                const std::vector<unsigned char>& coverage = variant == 0 ? glyphBitmap.coverage : glyphBitmap.subpixelBitmaps[variant - 1].coverage;
+
+                for (unsigned int j = 0; j < glyphMetrics.height_px; ++j)
+                {
+                    for (unsigned int i = 0; i < width_px; ++i)
+                    {
+                        unsigned int textureDataIndex = GetTextureIndex_H(
+                            i,
+                            offsetX,
+                            textureData.width,
+                            j,
+                            verticalSpacing,
+                            textureData.height);
+
+                        textureData.data[textureDataIndex] = 255;
+                        textureData.data[textureDataIndex + 1] = 255;
+                        textureData.data[textureDataIndex + 2] = 255;
+                        unsigned int sourceIndex = i + j * width_px;
+                        textureData.data[textureDataIndex + 3] = coverage[sourceIndex];
+                    }
+                }
+
+                offsetX += width_px + horizontalSpacing;
+            }
+        }
+
+        return true;
+    }
+
+    void ComposeTextureChannel_H(
+        TextureData& textureData,
+        const FontData& fontData,
+        const std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap,
+        const std::unordered_map<unsigned char, unsigned int>& glyphOffsetXMap,
+        unsigned int verticalSpacing,
+        unsigned char channel)
+    {
+        for (const auto& pair : fontData.glyphMetricsMap)
+        {
+            const GlyphMetrics& glyphMetrics = pair.second;
+            const std::vector<unsigned char>& coverage = glyphBitmapMap.at(pair.first).coverage;
+            unsigned int offsetX = glyphOffsetXMap.at(pair.first);
+
+            for (unsigned int j = 0; j < glyphMetrics.height_px; ++j)
+            {
+                for (unsigned int i = 0; i < glyphMetrics.width_px; ++i)
                 {
                     unsigned int textureDataIndex = GetTextureIndex_H(
                         i,
-                        nextCharacterOffsetX,
+                        offsetX,
                         textureData.width,
                         j,
-                        nextCharacterOffsetY,
+                        verticalSpacing,
                         textureData.height);
 
-                    textureData.data[textureDataIndex] = 255;
-                    textureData.data[textureDataIndex + 1] = 255;
-                    textureData.data[textureDataIndex + 2] = 255;
-                    unsigned int sourceIndex = i + j * glyphMetrics.width_px;
-                    textureData.data[textureDataIndex + 3] = face->glyph->bitmap.buffer[sourceIndex];
-                }
+                    textureData.data[textureDataIndex + channel] = coverage[i + j * glyphMetrics.width_px];
+                }
+            }
+        }
+    }
+
+    bool RenderOutlineBitmap_H(
+        GlyphBitmap& outlineBitmap,
+        bool& stroked,
+        FT_Library library,
+        FT_Face face,
+        unsigned char character,
+        unsigned int radius)
+    {
+        stroked = false;
+
+        // same hinting as FT_LOAD_RENDER so the stroke fits the glyph
+        FT_Error error = FT_Load_Char(face, character, FT_LOAD_DEFAULT);
+        if (error)
+        {
+            std::cerr << "ERROR: could not load character glyph for: " << character << std::endl;
+            return false;
+        }
+
+        // embedded bitmaps have nothing to stroke, they get dilated instead
+        if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE || face->glyph->outline.n_points == 0)
+        {
+            return true;
+        }
+
+        FT_Stroker stroker;
+        error = FT_Stroker_New(library, &stroker);
+        if (error)
+        {
+            std::cerr << "ERROR: could not create a stroker" << std::endl;
+            return false;
+        }
+        FT_Stroker_Set(
+            stroker,
+            static_cast<FT_Fixed>(radius) * METRICS_UNIT_MULTIPLIER,
+            FT_STROKER_LINECAP_ROUND,
+            FT_STROKER_LINEJOIN_ROUND,
+            0);
+
+        FT_Glyph glyph = nullptr;
+        error = FT_Get_Glyph(face->glyph, &glyph);
+        if (!error)
+        {
+            // the outside border covers the glyph and the ring around it
+            error = FT_Glyph_StrokeBorder(&glyph, stroker, false, true);
+            if (!error)
+            {
+                error = FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, nullptr, true);
+            }
+        }
+        FT_Stroker_Done(stroker);
+
+        if (error)
+        {
+            if (glyph != nullptr)
+            {
+                FT_Done_Glyph(glyph);
+            }
+            std::cerr << "ERROR: could not stroke character glyph for: " << character << std::endl;
+            return false;
+        }
+
+        FT_BitmapGlyph bitmapGlyph = reinterpret_cast<FT_BitmapGlyph>(glyph);
+        const FT_Bitmap& bitmap = bitmapGlyph->bitmap;
+        if (bitmap.pixel_mode != FT_Pixel_Mode::FT_PIXEL_MODE_GRAY)
+        {
+            FT_Done_Glyph(glyph);
+            std::cerr << "ERROR: glyph pixel mode not supported" << std::endl;
+            return false;
+        }
+
+        GlyphMetrics& glyphMetrics = outlineBitmap.metrics;
+        glyphMetrics.width_px = bitmap.width;
+        glyphMetrics.height_px = bitmap.rows;
+        glyphMetrics.horiBearingX_px = static_cast<unsigned int>(bitmapGlyph->left);
+        glyphMetrics.horiBearingY_px = static_cast<unsigned int>(bitmapGlyph->top);
+
+        outlineBitmap.coverage.resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+        for (unsigned int j = 0; j < bitmap.rows; ++j)
+        {
+            std::memcpy(
+                outlineBitmap.coverage.data() + j * bitmap.width,
+                bitmap.buffer + j * bitmap.pitch,
+                bitmap.width);
+        }
+
+        FT_Done_Glyph(glyph);
+        stroked = true;
+        return true;
+    }
+
+    void ApplyGlyphEffects_H(
+        std::vector<std::unordered_map<unsigned char, GlyphBitmap>>& layerBitmapMaps,
+        const std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap,
+        const std::unordered_map<unsigned char, GlyphBitmap>& outlineBitmapMap,
+        const EffectSettings& effectSettings,
+        unsigned int threadCount)
+    {
+        const unsigned int padding = effectSettings.GetPadding();
+        const bool hasLayer[] = {
+            effectSettings.outlineRadius_px > 0,
+            effectSettings.glowRadius_px > 0,
+            effectSettings.HasShadow(),
+            true };
+
+        // every layer bitmap is made here, the threads only fill them in
+        std::vector<const unsigned char*> characters;
+        characters.reserve(glyphBitmapMap.size());
+        for (const auto& pair : glyphBitmapMap)
+        {
+            GlyphMetrics glyphMetrics = pair.second.metrics;
+            if (glyphMetrics.width_px != 0 && glyphMetrics.height_px != 0)
+            {
+                // bearings are two's complement, unsigned arithmetic wraps the same way
+                glyphMetrics.width_px += 2 * padding;
+                glyphMetrics.height_px += 2 * padding;
+                glyphMetrics.horiBearingX_px -= padding;
+                glyphMetrics.horiBearingY_px += padding;
+                glyphMetrics.vertBearingX_px -= padding;
+                glyphMetrics.vertBearingY_px -= padding;
+            }
+
+            for (size_t channel = 0; channel < layerBitmapMaps.size(); ++channel)
+            {
+                if (hasLayer[channel])
+                {
+                    GlyphBitmap& layerBitmap = layerBitmapMaps[channel][pair.first];
+                    layerBitmap.metrics = glyphMetrics;
+                    layerBitmap.sourceIndex = pair.second.sourceIndex;
+                    layerBitmap.coverage.assign(static_cast<size_t>(glyphMetrics.width_px) * glyphMetrics.height_px, 0);
+                }
+            }
+            characters.push_back(&pair.first);
+        }
+
+        struct EffectScratch
+        {
+            std::vector<unsigned char> dilation;
+            std::vector<float> blur;
+        };
+
+        ForEachGlyphInParallel_H<EffectScratch>(characters.size(), threadCount, [&](size_t i, EffectScratch& scratch)
+        {
+            const unsigned char c = *characters[i];
+            const GlyphBitmap& glyphBitmap = glyphBitmapMap.at(c);
+            const GlyphMetrics& glyphMetrics = glyphBitmap.metrics;
+            if (glyphMetrics.width_px == 0 || glyphMetrics.height_px == 0)
+            {
+                return;
+            }
+
+            GlyphBitmap& fillBitmap = layerBitmapMaps[GlyphMetrics::ALPHA_CHANNEL].at(c);
+            const unsigned int width = fillBitmap.metrics.width_px;
+            const unsigned int height = fillBitmap.metrics.height_px;
+            BlitCoverage_H(
+                fillBitmap.coverage,
+                width,
+                height,
+                glyphBitmap.coverage,
+                glyphMetrics.width_px,
+                glyphMetrics.height_px,
+                static_cast<int>(padding),
+                static_cast<int>(padding));
+
+            if (hasLayer[EffectSettings::OUTLINE_CHANNEL])
+            {
+                GlyphBitmap& outlineLayer = layerBitmapMaps[EffectSettings::OUTLINE_CHANNEL].at(c);
+                auto outline = outlineBitmapMap.find(c);
+                if (outline != outlineBitmapMap.end())
+                {
+                    // the stroke bitmap is placed relative to the glyph bitmap
+                    const GlyphMetrics& outlineMetrics = outline->second.metrics;
+                    BlitCoverage_H(
+                        outlineLayer.coverage,
+                        width,
+                        height,
+                        outline->second.coverage,
+                        outlineMetrics.width_px,
+                        outlineMetrics.height_px,
+                        static_cast<int>(padding) + static_cast<int>(outlineMetrics.horiBearingX_px) - static_cast<int>(glyphMetrics.horiBearingX_px),
+                        static_cast<int>(padding) + static_cast<int>(glyphMetrics.horiBearingY_px) - static_cast<int>(outlineMetrics.horiBearingY_px));
+                }
+                else
+                {
+                    outlineLayer.coverage = fillBitmap.coverage;
+                    DilateCoverage(outlineLayer.coverage, scratch.dilation, width, height, effectSettings.outlineRadius_px);
+                }
+            }
+
+            if (hasLayer[EffectSettings::GLOW_CHANNEL])
+            {
+                GlyphBitmap& glowLayer = layerBitmapMaps[EffectSettings::GLOW_CHANNEL].at(c);
+                unsigned int blurRadius = effectSettings.glowRadius_px / 2;
+                glowLayer.coverage = fillBitmap.coverage;
+                DilateCoverage(glowLayer.coverage, scratch.dilation, width, height, effectSettings.glowRadius_px - blurRadius);
+                BlurCoverage(glowLayer.coverage, scratch.blur, width, height, blurRadius);
+            }
+
+            if (hasLayer[EffectSettings::SHADOW_CHANNEL])
+            {
+                GlyphBitmap& shadowLayer = layerBitmapMaps[EffectSettings::SHADOW_CHANNEL].at(c);
+                BlitCoverage_H(
+                    shadowLayer.coverage,
+                    width,
+                    height,
+                    glyphBitmap.coverage,
+                    glyphMetrics.width_px,
+                    glyphMetrics.height_px,
+                    static_cast<int>(padding) + effectSettings.shadowOffsetX_px,
+                    static_cast<int>(padding) + effectSettings.shadowOffsetY_px);
+                BlurCoverage(shadowLayer.coverage, scratch.blur, width, height, effectSettings.shadowRadius_px);
+            }
+        });
+    }
+
+    void BlitCoverage_H(
+        std::vector<unsigned char>& destination,
+        unsigned int destinationWidth,
+        unsigned int destinationHeight,
+        const std::vector<unsigned char>& source,
+        unsigned int width,
+        unsigned int height,
+        int x,
+        int y)
+    {
+        int firstColumn = std::max(-x, 0);
+        int lastColumn = std::min(static_cast<int>(width), static_cast<int>(destinationWidth) - x);
+        if (firstColumn >= lastColumn)
+        {
+            return;
+        }
+
+        for (int j = std::max(-y, 0); j < static_cast<int>(height) && j + y < static_cast<int>(destinationHeight); ++j)
+        {
+            std::memcpy(
+                destination.data() + static_cast<size_t>(j + y) * destinationWidth + (x + firstColumn),
+                source.data() + static_cast<size_t>(j) * width + firstColumn,
+                static_cast<size_t>(lastColumn - firstColumn));
+        }
+    }
+
+    bool RasterizeOutlineCache_H(
+        std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap,
+        const OutlineCache& outlineCache,
+        unsigned int fontHeightInPixels,
+        unsigned int threadCount)
+    {
+        // every glyph bitmap is made here, the threads only rasterize into them
+        glyphBitmapMap.clear();
+        std::vector<std::pair<const GlyphOutline*, GlyphBitmap*>> glyphs;
+        glyphs.reserve(outlineCache.glyphOutlineMap.size());
+        for (const auto& pair : outlineCache.glyphOutlineMap)
+        {
+            const GlyphOutline& glyphOutline = pair.second;
+            const OutlineSource& outlineSource = outlineCache.outlineSources[glyphOutline.sourceIndex];
+            float scale = static_cast<float>(fontHeightInPixels) / outlineSource.unitsPerEm;
+
+            GlyphBitmap& glyphBitmap = glyphBitmapMap[pair.first];
+            glyphBitmap.sourceIndex = glyphOutline.sourceIndex;
+            SetGlyphMetrics_H(glyphBitmap.metrics, glyphOutline, scale);
+            glyphs.push_back(std::make_pair(&glyphOutline, &glyphBitmap));
+        }
+
+        // the scratch is the coverage accumulation buffer of RasterizeGlyphOutline
+        ForEachGlyphInParallel_H<std::vector<float>>(glyphs.size(), threadCount, [&](size_t i, std::vector<float>& accumulation)
+        {
+            const GlyphOutline& glyphOutline = *glyphs[i].first;
+            GlyphBitmap& glyphBitmap = *glyphs[i].second;
+            const GlyphMetrics& glyphMetrics = glyphBitmap.metrics;
+            float scale = static_cast<float>(fontHeightInPixels) / outlineCache.outlineSources[glyphOutline.sourceIndex].unitsPerEm;
+
+            RasterizeGlyphOutline(
+                glyphBitmap.coverage,
+                accumulation,
+                glyphOutline,
+                scale,
+                -static_cast<float>(static_cast<int>(glyphMetrics.horiBearingX_px)),
+                static_cast<float>(static_cast<int>(glyphMetrics.horiBearingY_px)),
+                glyphMetrics.width_px,
+                glyphMetrics.height_px);
+        });
+
+        return true;
+    }
+
+    bool LoadGlyphOutline_H(
+        GlyphOutline& glyphOutline,
+        FT_Face face,
+        unsigned char character,
+        float tolerance)
+    {
+        FT_Error error = FT_Load_Char(face, character, FT_LOAD_NO_SCALE);
+        if (error)
+        {
+            std::cerr << "ERROR: could not load character glyph for: " << character << std::endl;
+            return false;
+        }
+
+        FT_GlyphSlot glyph = face->glyph;
+        if (glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+        {
+            std::cerr << "ERROR: glyph has no outline: " << character << std::endl;
+            return false;
+        }
+
+        // without scaling the metrics are in font units
+        glyphOutline.horiAdvance = static_cast<float>(glyph->metrics.horiAdvance);
+        glyphOutline.vertBearingX = static_cast<float>(glyph->metrics.vertBearingX);
+        glyphOutline.vertBearingY = static_cast<float>(glyph->metrics.vertBearingY);
+        glyphOutline.vertAdvance = static_cast<float>(glyph->metrics.vertAdvance);
+
+        // FreeType renders the control box, so it bounds the bitmap here too
+        FT_BBox cbox;
+        FT_Outline_Get_CBox(&glyph->outline, &cbox);
+        glyphOutline.xMin = static_cast<float>(cbox.xMin);
+        glyphOutline.yMin = static_cast<float>(cbox.yMin);
+        glyphOutline.xMax = static_cast<float>(cbox.xMax);
+        glyphOutline.yMax = static_cast<float>(cbox.yMax);
+
+        OutlineFlattener flattener = { &glyphOutline, tolerance, 0.0f, 0.0f };
+        FT_Outline_Funcs outlineFuncs = {};
+        outlineFuncs.move_to = FlattenMoveTo_H;
+        outlineFuncs.line_to = FlattenLineTo_H;
+        outlineFuncs.conic_to = FlattenConicTo_H;
+        outlineFuncs.cubic_to = FlattenCubicTo_H;
+
+        glyphOutline.edges.clear();
+        error = FT_Outline_Decompose(&glyph->outline, &outlineFuncs, &flattener);
+        if (error)
+        {
+            std::cerr << "ERROR: could not decompose the glyph outline for: " << character << std::endl;
+            return false;
+        }
+        glyphOutline.edges.shrink_to_fit();
+
+        return true;
+    }
+
+    bool LoadFontData_H(
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels)
+    {
+        if (!PrepareFontData_H(fontData, glyphSourceMap, characterList, faces, fontHeightInPixels))
+        {
+            return false;
+        }
+
+        for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = fontData.glyphMetricsMap.begin(); iter != fontData.glyphMetricsMap.end(); ++iter)
+        {
+            const unsigned char& c = iter->first;
+            FT_Face face = faces[glyphSourceMap[c]];
+
+            // same hinting as FT_LOAD_RENDER, just without rasterizing
+            FT_Error error = FT_Load_Char(face, c, FT_LOAD_DEFAULT);
+            if (error)
+            {
+                std::cerr << "ERROR: could not load character glyph for: " << c << std::endl;
+                return false;
+            }
+
+            GlyphMetrics& glyphMetrics = iter->second;
+            SetGlyphMetrics_H(glyphMetrics, face->glyph);
+            glyphMetrics.textureLeft = 0.0f;
+            glyphMetrics.textureRight = 0.0f;
+            glyphMetrics.textureBottom = 0.0f;
+            glyphMetrics.textureTop = 0.0f;
+        }
+
+        return true;
+    }
+
+    bool PrepareFontData_H(
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels)
+    {
+        if (faces.empty())
+        {
+            std::cerr << "ERROR: no font faces" << std::endl;
+            return false;
+        }
+
+        for (FT_Face face : faces)
+        {
+            FT_Error error = FT_Set_Pixel_Sizes(face, 0, fontHeightInPixels);
+            if (error)
+            {
+                std::cerr << "ERROR: could not set font pixel sizes" << std::endl;
+                return false;
+            }
+        }
+
+        std::unordered_map<unsigned char, GlyphMetrics>& glyphMetricsMap = fontData.glyphMetricsMap;
+
+        for (size_t i = 0; i < characterList.size(); ++i)
+        {
+            const unsigned char& c = characterList[i];
+            if (fontData.glyphMetricsMap.find(c) != fontData.glyphMetricsMap.end())
+            {
+                std::cout << "WARNING: reloading character glyph for: " << c << std::endl;
+            }
+            else
+            {
+                glyphMetricsMap[c];
             }
+        }
+
+        std::vector<unsigned char> characters;
+        characters.reserve(glyphMetricsMap.size());
+        for (const auto& pair : glyphMetricsMap)
+        {
+            characters.push_back(pair.first);
+        }
 
-            // spacing below glyph
-            for (unsigned int j = glyphMetrics.height_px; j < textureData.height - verticalSpacing; ++j)
+        std::vector<bool> faceUsed;
+        ResolveGlyphSources_H(glyphSourceMap, faceUsed, characters, faces);
+
+        // glyph bearings are all relative to the baseline, so the faces share
+        // it as long as the line spacing fits the tallest face that was used
+        fontData.lineSpacing_px = 0;
+        for (size_t i = 0; i < faces.size(); ++i)
+        {
+            unsigned int faceLineSpacing_px = faces[i]->size->metrics.height / METRICS_UNIT_MULTIPLIER;
+            if (faceUsed[i] && faceLineSpacing_px > fontData.lineSpacing_px)
             {
-                for (unsigned int i = 0; i < glyphMetrics.width_px; ++i)
+                fontData.lineSpacing_px = faceLineSpacing_px;
+            }
+        }
+
+        return true;
+    }
+
+    void ResolveGlyphSources_H(
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        std::vector<bool>& faceUsed,
+        const std::vector<unsigned char>& characters,
+        const std::vector<FT_Face>& faces)
+    {
+        // resolve every character to the first face that has a glyph for it
+        faceUsed.assign(faces.size(), false);
+        faceUsed[0] = true;
+        glyphSourceMap.clear();
+        for (unsigned char c : characters)
+        {
+            unsigned int faceIndex = 0;
+            while (faceIndex < faces.size() && FT_Get_Char_Index(faces[faceIndex], c) == 0)
+            {
+                ++faceIndex;
+            }
+            if (faceIndex == faces.size())
+            {
+                std::cout << "WARNING: no font has a glyph for: " << c << std::endl;
+                faceIndex = 0;
+            }
+            glyphSourceMap[c] = faceIndex;
+            faceUsed[faceIndex] = true;
+        }
+    }
+
+    void SetGlyphMetrics_H(
+        GlyphMetrics& glyphMetrics,
+        FT_GlyphSlot glyph)
+    {
+        if (glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+        {
+            // the rasterizer covers the control box rounded out to whole
+            // pixels, which matches the bitmap it would render exactly
+            FT_BBox cbox;
+            FT_Outline_Get_CBox(&glyph->outline, &cbox);
+            glyphMetrics.width_px = static_cast<unsigned int>((((cbox.xMax + 63) & -64) - (cbox.xMin & -64)) / METRICS_UNIT_MULTIPLIER);
+            glyphMetrics.height_px = static_cast<unsigned int>((((cbox.yMax + 63) & -64) - (cbox.yMin & -64)) / METRICS_UNIT_MULTIPLIER);
+        }
+        else
+        {
+            glyphMetrics.width_px = glyph->bitmap.width;
+            glyphMetrics.height_px = glyph->bitmap.rows;
+        }
+        glyphMetrics.horiBearingX_px = glyph->metrics.horiBearingX / METRICS_UNIT_MULTIPLIER;
+        glyphMetrics.horiBearingY_px = glyph->metrics.horiBearingY / METRICS_UNIT_MULTIPLIER;
+        glyphMetrics.horiAdvance_px = glyph->metrics.horiAdvance / METRICS_UNIT_MULTIPLIER;
+        glyphMetrics.vertBearingX_px = glyph->metrics.vertBearingX / METRICS_UNIT_MULTIPLIER;
+        glyphMetrics.vertBearingY_px = glyph->metrics.vertBearingY / METRICS_UNIT_MULTIPLIER;
+        glyphMetrics.vertAdvance_px = glyph->metrics.vertAdvance / METRICS_UNIT_MULTIPLIER;
+    }
+
+    void SetGlyphMetrics_H(
+        GlyphMetrics& glyphMetrics,
+        const GlyphOutline& glyphOutline,
+        float scale)
+    {
+        // the control box rounded out to whole pixels, like FreeType does
+        int left = 0;
+        int right = 0;
+        int bottom = 0;
+        int top = 0;
+        if (!glyphOutline.edges.empty())
+        {
+            left = static_cast<int>(std::floor(glyphOutline.xMin * scale));
+            right = static_cast<int>(std::ceil(glyphOutline.xMax * scale));
+            bottom = static_cast<int>(std::floor(glyphOutline.yMin * scale));
+            top = static_cast<int>(std::ceil(glyphOutline.yMax * scale));
+        }
+        glyphMetrics.width_px = static_cast<unsigned int>(right - left);
+        glyphMetrics.height_px = static_cast<unsigned int>(top - bottom);
+        glyphMetrics.horiBearingX_px = static_cast<unsigned int>(left);
+        glyphMetrics.horiBearingY_px = static_cast<unsigned int>(top);
+        glyphMetrics.horiAdvance_px = static_cast<unsigned int>(std::lround(glyphOutline.horiAdvance * scale));
+        glyphMetrics.vertBearingX_px = static_cast<unsigned int>(std::lround(glyphOutline.vertBearingX * scale));
+        glyphMetrics.vertBearingY_px = static_cast<unsigned int>(std::lround(glyphOutline.vertBearingY * scale));
+        glyphMetrics.vertAdvance_px = static_cast<unsigned int>(std::lround(glyphOutline.vertAdvance * scale));
+    }
+
+    void PackFontData_H(
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphOffsetXMap,
+        unsigned int& textureWidth,
+        unsigned int& textureHeight,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing,
+        const std::vector<unsigned char>& packOrder)
+    {
+        // glyphs are laid out in a single row, every glyph is surrounded by
+        // spacing and sits on the top edge of its row. The subpixel variants
+        // of a glyph follow it in the row, glyphOffsetXMap has where the
+        // glyph itself starts.
+        textureWidth = horizontalSpacing;
+        textureHeight = verticalSpacing * 2;
+        unsigned int nextCharacterOffsetX = horizontalSpacing;
+
+        // the glyphs of packOrder go first, the rest follow in map order
+        std::vector<unsigned char> characters;
+        characters.reserve(fontData.glyphMetricsMap.size());
+        std::vector<bool> isPlaced(256, false);
+        for (unsigned char c : packOrder)
+        {
+            if (!isPlaced[c] && fontData.glyphMetricsMap.find(c) != fontData.glyphMetricsMap.end())
+            {
+                characters.push_back(c);
+                isPlaced[c] = true;
+            }
+        }
+        for (const auto& pair : fontData.glyphMetricsMap)
+        {
+            if (!isPlaced[pair.first])
+            {
+                characters.push_back(pair.first);
+            }
+        }
+
+        glyphOffsetXMap.clear();
+        for (unsigned char c : characters)
+        {
+            const GlyphMetrics& glyphMetrics = fontData.glyphMetricsMap.at(c);
+            if (glyphMetrics.height_px + verticalSpacing * 2 > textureHeight)
+            {
+                textureHeight = glyphMetrics.height_px + verticalSpacing * 2;
+            }
+
+            glyphOffsetXMap[c] = nextCharacterOffsetX;
+            nextCharacterOffsetX += glyphMetrics.width_px + horizontalSpacing;
+
+            auto variants = fontData.subpixelVariantMap.find(c);
+            if (variants != fontData.subpixelVariantMap.end())
+            {
+                for (const SubpixelVariant& subpixelVariant : variants->second)
                 {
-                    unsigned int textureDataIndex = GetTextureIndex_H(
-                        i,
-                        nextCharacterOffsetX,
-                        textureData.width,
-                        j,
-                        nextCharacterOffsetY,
-                        textureData.height);
+                    nextCharacterOffsetX += subpixelVariant.width_px + horizontalSpacing;
+                }
+            }
+        }
+        textureWidth = nextCharacterOffsetX;
+
+        SetTextureCoordinates_H(
+            fontData,
+            glyphOffsetXMap,
+            textureWidth,
+            textureHeight,
+            horizontalSpacing,
+            verticalSpacing);
+    }
+
+    void SetTextureCoordinates_H(
+        FontData& fontData,
+        const std::unordered_map<unsigned char, unsigned int>& glyphOffsetXMap,
+        unsigned int textureWidth,
+        unsigned int textureHeight,
+        unsigned int horizontalSpacing,
+        unsigned int verticalSpacing)
+    {
+        // every glyph sits on the top edge of its row
+        unsigned int nextCharacterOffsetY = verticalSpacing;
+
+        for (std::unordered_map<unsigned char, GlyphMetrics>::iterator iter = fontData.glyphMetricsMap.begin(); iter != fontData.glyphMetricsMap.end(); ++iter)
+        {
+            GlyphMetrics& glyphMetrics = iter->second;
+            unsigned int nextCharacterOffsetX = glyphOffsetXMap.at(iter->first);
 
-                    textureData.data[textureDataIndex] = 0;
-                    textureData.data[textureDataIndex + 1] = 0;
-                    textureData.data[textureDataIndex + 2] = 0;
-                    textureData.data[textureDataIndex + 3] = 0;
+            auto variants = fontData.subpixelVariantMap.find(iter->first);
+            if (variants != fontData.subpixelVariantMap.end())
+            {
+                // the variants share the rows of the glyph
+                unsigned int variantOffsetX = nextCharacterOffsetX + glyphMetrics.width_px + horizontalSpacing;
+                for (SubpixelVariant& subpixelVariant : variants->second)
+                {
+                    subpixelVariant.textureLeft = (float)variantOffsetX / (float)textureWidth;
+                    subpixelVariant.textureRight = (float)(variantOffsetX + subpixelVariant.width_px) / (float)textureWidth;
+                    if (s_textureCoordinatesFlippedVertically)
+                    {
+                        subpixelVariant.textureBottom = (float)(textureHeight - glyphMetrics.height_px - nextCharacterOffsetY) / (float)textureHeight;
+                        subpixelVariant.textureTop = (float)(textureHeight - nextCharacterOffsetY) / (float)textureHeight;
+                    }
+                    else
+                    {
+                        subpixelVariant.textureBottom = (float)(glyphMetrics.height_px + nextCharacterOffsetY) / (float)textureHeight;
+                        subpixelVariant.textureTop = (float)(nextCharacterOffsetY) / (float)textureHeight;
+                    }
+                    variantOffsetX += subpixelVariant.width_px + horizontalSpacing;
                 }
             }
 
-            nextCharacterOffsetX += glyphMetrics.width_px;
+            glyphMetrics.textureLeft = (float)nextCharacterOffsetX / (float)textureWidth;
+            glyphMetrics.textureRight = (float)(nextCharacterOffsetX + glyphMetrics.width_px) / (float)textureWidth;
+            if (s_textureCoordinatesFlippedVertically)
+            {
+                glyphMetrics.textureBottom = (float)(textureHeight - glyphMetrics.height_px - nextCharacterOffsetY) / (float)textureHeight;
+                glyphMetrics.textureTop = (float)(textureHeight - nextCharacterOffsetY) / (float)textureHeight;
+            }
+            else
+            {
+                glyphMetrics.textureBottom = (float)(glyphMetrics.height_px + nextCharacterOffsetY) / (float)textureHeight;
+                glyphMetrics.textureTop = (float)(nextCharacterOffsetY) / (float)textureHeight;
+            }
+        }
+    }
+
+    bool OpenFontSources_H(
+        FT_Library& library,
+        std::vector<FT_Face>& faces,
+        const std::vector<FontSource>& fontSources)
+    {
+        if (fontSources.empty())
+        {
+            std::cerr << "ERROR: no font sources" << std::endl;
+            return false;
+        }
+
+        FT_Error error = FT_Init_FreeType(&library);
+        if (error)
+        {
+            std::cerr << "ERROR: could not initalize the FreeType library" << std::endl;
+            return false;
         }
 
-        // right side spacing
-        for (unsigned int j = 0; j < textureData.height - verticalSpacing; ++j)
+        faces.clear();
+        faces.reserve(fontSources.size());
+        for (const FontSource& fontSource : fontSources)
         {
-            for (unsigned int i = 0; i < horizontalSpacing; ++i)
+            FT_Face face;
+            error = FT_New_Face(library, fontSource.filePath.c_str(), fontSource.faceIndex, &face);
+            if (error)
             {
-                unsigned int textureDataIndex = GetTextureIndex_H(
-                    i,
-                    nextCharacterOffsetX,
-                    textureData.width,
-                    j,
-                    nextCharacterOffsetY,
-                    textureData.height);
+                std::cerr << "ERROR: failed to load the font: " << fontSource.filePath << " (face " << fontSource.faceIndex << ")" << std::endl;
+                CloseFontSources_H(library, faces);
+                return false;
+            }
+            faces.push_back(face);
+        }
+
+        return true;
+    }
+
+    void CloseFontSources_H(
+        FT_Library library,
+        std::vector<FT_Face>& faces)
+    {
+        for (FT_Face face : faces)
+        {
+            FT_Done_Face(face);
+        }
+        faces.clear();
+        FT_Done_FreeType(library);
+    }
+
+    bool DecodeFontDataHeader_H(
+        unsigned int& version,
+        const unsigned char* dataPtr,
+        size_t dataSize,
+        size_t& offset)
+    {
+        if (dataSize - offset < 12 || std::memcmp(dataPtr + offset, "FSSDATA", 8) != 0)
+        {
+            std::cerr << "ERROR: invalid file signature" << std::endl;
+            return false;
+        }
+        offset += 8; // ----------------------------------------------------------- 8 bytes
+
+        ReadBytes_H(&version, dataPtr, offset, 4); // ------------------------------ 4 bytes
+        if (version != 1 && version != 2 && version != 3 && version != 4)
+        {
+            std::cerr << "ERROR: unsupported version" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool DecodeFontDataBody_H(
+        FontData& fontData,
+        unsigned int version,
+        const unsigned char* dataPtr,
+        size_t dataSize,
+        size_t& offset)
+    {
+        const bool hasChannels = version == 3 || version == 4;
+        const bool hasSubpixelVariants = version == 4;
+
+        if (dataSize - offset < (hasSubpixelVariants ? 12u : 8u))
+        {
+            std::cerr << "ERROR: unexpected end of font data" << std::endl;
+            return false;
+        }
+
+        ReadBytes_H(&fontData.lineSpacing_px, dataPtr, offset, 4); // ------------- 4 bytes
 
-                textureData.data[textureDataIndex] = 0;
-                textureData.data[textureDataIndex + 1] = 0;
-                textureData.data[textureDataIndex + 2] = 0;
-                textureData.data[textureDataIndex + 3] = 0;
+        unsigned int glyphCount = 0;
+        ReadBytes_H(&glyphCount, dataPtr, offset, 4); // --------------------------- 4 bytes
+
+        fontData.subpixelVariantCount = 1;
+        fontData.subpixelVariantMap.clear();
+        if (hasSubpixelVariants)
+        {
+            ReadBytes_H(&fontData.subpixelVariantCount, dataPtr, offset, 4); // ---- 4 bytes
+            if (fontData.subpixelVariantCount < 1 || fontData.subpixelVariantCount > FontData::MAX_SUBPIXEL_VARIANT_COUNT)
+            {
+                std::cerr << "ERROR: invalid subpixel variant count" << std::endl;
+                return false;
             }
         }
 
-        // bottom side spacing
-        for (unsigned int j = 0; j < verticalSpacing; ++j)
+        const size_t GLYPH_SIZE = (hasChannels ? 50 : 49) + (fontData.subpixelVariantCount - 1) * 24;
+
+        if ((dataSize - offset) / GLYPH_SIZE < glyphCount)
+        {
+            std::cerr << "ERROR: unexpected end of font data" << std::endl;
+            return false;
+        }
+
+        // fontData.glyphMetricsMap.clear();
+
+        for (unsigned int i = 0; i < glyphCount; ++i)
         {
-            for (unsigned int i = 0; i < textureData.width; ++i)
+            unsigned char glyph;
+            ReadBytes_H(&glyph, dataPtr, offset, 1); // ---------------------------- 1 byte
+
+            GlyphMetrics metrics;
+            ReadBytes_H(&metrics.width_px, dataPtr, offset, 4); // ----------------- 4 bytes
+            ReadBytes_H(&metrics.height_px, dataPtr, offset, 4); // ---------------- 4 bytes
+            ReadBytes_H(&metrics.horiBearingX_px, dataPtr, offset, 4); // ---------- 4 bytes
+            ReadBytes_H(&metrics.horiBearingY_px, dataPtr, offset, 4); // ---------- 4 bytes
+            ReadBytes_H(&metrics.horiAdvance_px, dataPtr, offset, 4); // ----------- 4 bytes
+            ReadBytes_H(&metrics.vertBearingX_px, dataPtr, offset, 4); // ---------- 4 bytes
+            ReadBytes_H(&metrics.vertBearingY_px, dataPtr, offset, 4); // ---------- 4 bytes
+            ReadBytes_H(&metrics.vertAdvance_px, dataPtr, offset, 4); // ----------- 4 bytes
+
+            ReadBytes_H(&metrics.textureLeft, dataPtr, offset, 4); // -------------- 4 bytes
+            ReadBytes_H(&metrics.textureRight, dataPtr, offset, 4); // ------------- 4 bytes
+            ReadBytes_H(&metrics.textureBottom, dataPtr, offset, 4); // ------------ 4 bytes
+            ReadBytes_H(&metrics.textureTop, dataPtr, offset, 4); // --------------- 4 bytes
+
+            if (hasChannels)
             {
-                unsigned int textureDataIndex = GetTextureIndex_H(
-                    i,
-                    0,
-                    textureData.width,
-                    j,
-                    textureData.height - verticalSpacing,
-                    textureData.height);
+                ReadBytes_H(&metrics.channel, dataPtr, offset, 1); // -------------- 1 byte
+                if (metrics.channel > 3)
+                {
+                    std::cerr << "ERROR: invalid glyph channel" << std::endl;
+                    return false;
+                }
+            }
 
-                textureData.data[textureDataIndex] = 0;
-                textureData.data[textureDataIndex + 1] = 0;
-                textureData.data[textureDataIndex + 2] = 0;
-                textureData.data[textureDataIndex + 3] = 0;
+            if (fontData.subpixelVariantCount > 1)
+            {
+                std::vector<SubpixelVariant>& subpixelVariants = fontData.subpixelVariantMap[glyph];
+                subpixelVariants.resize(fontData.subpixelVariantCount - 1);
+                for (SubpixelVariant& subpixelVariant : subpixelVariants)
+                {
+                    ReadBytes_H(&subpixelVariant.width_px, dataPtr, offset, 4); // ----- 4 bytes
+                    ReadBytes_H(&subpixelVariant.horiBearingX_px, dataPtr, offset, 4); // 4 bytes
+                    ReadBytes_H(&subpixelVariant.textureLeft, dataPtr, offset, 4); // -- 4 bytes
+                    ReadBytes_H(&subpixelVariant.textureRight, dataPtr, offset, 4); // - 4 bytes
+                    ReadBytes_H(&subpixelVariant.textureBottom, dataPtr, offset, 4); //  4 bytes
+                    ReadBytes_H(&subpixelVariant.textureTop, dataPtr, offset, 4); // --- 4 bytes
+                }
             }
+
+            fontData.glyphMetricsMap[glyph] = metrics;
+        }
+
+        return true;
+    }
+
+    bool DecodeCompactFontDataBody_H(
+        CompactFontData& compactFontData,
+        const unsigned char* dataPtr,
+        size_t dataSize,
+        size_t& offset)
+    {
+        const size_t GLYPH_SIZE = 25;
+
+        compactFontData.Clear();
+
+        if (dataSize - offset < 4)
+        {
+            std::cerr << "ERROR: unexpected end of font data" << std::endl;
+            return false;
+        }
+
+        ReadBytes_H(&compactFontData.lineSpacing_px, dataPtr, offset, 2); // ------- 2 bytes
+
+        unsigned short glyphCount = 0;
+        ReadBytes_H(&glyphCount, dataPtr, offset, 2); // ---------------------------- 2 bytes
+        if (glyphCount > 256)
+        {
+            std::cerr << "ERROR: invalid glyph count" << std::endl;
+            return false;
+        }
+
+        if ((dataSize - offset) / GLYPH_SIZE < glyphCount)
+        {
+            std::cerr << "ERROR: unexpected end of font data" << std::endl;
+            return false;
+        }
+
+        compactFontData.characters.resize(glyphCount);
+        ReadBytes_H(compactFontData.characters.data(), dataPtr, offset, glyphCount); // -------- 1 byte each
+        compactFontData.width_px.resize(glyphCount);
+        ReadBytes_H(compactFontData.width_px.data(), dataPtr, offset, glyphCount * 2); // ------ 2 bytes each
+        compactFontData.height_px.resize(glyphCount);
+        ReadBytes_H(compactFontData.height_px.data(), dataPtr, offset, glyphCount * 2); // ----- 2 bytes each
+        compactFontData.horiBearingX_px.resize(glyphCount);
+        ReadBytes_H(compactFontData.horiBearingX_px.data(), dataPtr, offset, glyphCount * 2); // 2 bytes each
+        compactFontData.horiBearingY_px.resize(glyphCount);
+        ReadBytes_H(compactFontData.horiBearingY_px.data(), dataPtr, offset, glyphCount * 2); // 2 bytes each
+        compactFontData.horiAdvance_px.resize(glyphCount);
+        ReadBytes_H(compactFontData.horiAdvance_px.data(), dataPtr, offset, glyphCount * 2); // 2 bytes each
+        compactFontData.vertBearingX_px.resize(glyphCount);
+        ReadBytes_H(compactFontData.vertBearingX_px.data(), dataPtr, offset, glyphCount * 2); // 2 bytes each
+        compactFontData.vertBearingY_px.resize(glyphCount);
+        ReadBytes_H(compactFontData.vertBearingY_px.data(), dataPtr, offset, glyphCount * 2); // 2 bytes each
+        compactFontData.vertAdvance_px.resize(glyphCount);
+        ReadBytes_H(compactFontData.vertAdvance_px.data(), dataPtr, offset, glyphCount * 2); // 2 bytes each
+        compactFontData.textureLeft.resize(glyphCount);
+        ReadBytes_H(compactFontData.textureLeft.data(), dataPtr, offset, glyphCount * 2); // --- 2 bytes each
+        compactFontData.textureRight.resize(glyphCount);
+        ReadBytes_H(compactFontData.textureRight.data(), dataPtr, offset, glyphCount * 2); // -- 2 bytes each
+        compactFontData.textureBottom.resize(glyphCount);
+        ReadBytes_H(compactFontData.textureBottom.data(), dataPtr, offset, glyphCount * 2); // - 2 bytes each
+        compactFontData.textureTop.resize(glyphCount);
+        ReadBytes_H(compactFontData.textureTop.data(), dataPtr, offset, glyphCount * 2); // ---- 2 bytes each
+
+        for (unsigned short slot = 0; slot < glyphCount; ++slot)
+        {
+            compactFontData.slotMap[compactFontData.characters[slot]] = slot;
+        }
+
+        return true;
+    }
+
+    void AppendBytes_H(
+        std::vector<unsigned char>& buffer,
+        const void* source,
+        size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(source);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    void ReadBytes_H(
+        void* destination,
+        const unsigned char* dataPtr,
+        size_t& offset,
+        size_t size)
+    {
+        std::memcpy(destination, dataPtr + offset, size);
+        offset += size;
+    }
+
+    void AppendPngData_H(
+        void* context,
+        void* data,
+        int size)
+    {
+        AppendBytes_H(*static_cast<std::vector<unsigned char>*>(context), data, static_cast<size_t>(size));
+    }
+
+    bool WriteFile_H(
+        const unsigned char* dataPtr,
+        size_t dataSize,
+        const std::string& filePath)
+    {
+        // written next to the target and renamed over it, so a program
+        // loading the file never sees it half written
+        std::string temporaryFilePath = filePath + ".tmp";
+        std::ofstream fileStream(temporaryFilePath, std::ios::binary);
+
+        if (!fileStream.is_open())
+        {
+            std::cerr << "ERROR: failed to open file" << std::endl;
+            return false;
         }
 
-        textureData.bytesPerPixel = 4;
+        fileStream.write(reinterpret_cast<const char*>(dataPtr), dataSize);
+
+        fileStream.close();
+
+        if (fileStream.fail())
+        {
+            std::cerr << "ERROR: file stream error" << std::endl;
+            std::remove(temporaryFilePath.c_str());
+            return false;
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(temporaryFilePath, filePath, errorCode);
+        if (errorCode)
+        {
+            std::cerr << "ERROR: failed to replace file: " << errorCode.message() << std::endl;
+            std::remove(temporaryFilePath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ReadFile_H(
+        std::vector<unsigned char>& buffer,
+        const std::string& filePath)
+    {
+        std::ifstream fileStream(filePath, std::ios::binary | std::ios::ate);
+
+        if (!fileStream.is_open())
+        {
+            std::cerr << "ERROR: failed to open file" << std::endl;
+            return false;
+        }
+
+        std::streamoff fileSize = fileStream.tellg();
+        fileStream.seekg(0, std::ios::beg);
+        buffer.resize(static_cast<size_t>(fileSize));
+        fileStream.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+
+        fileStream.close();
+
+        if (fileStream.bad())
+        {
+            std::cerr << "ERROR: file stream error" << std::endl;
+            return false;
+        }
 
         return true;
     }
@@ -4,15 +4,24 @@
 
 #pragma once
 
+#include "CompactFontData.h"
+#include "Effects.h"
 #include "FontData.h"
+#include "FontSource.h"
+#include "GlyphCache.h"
+#include "OutlineCache.h"
+#include "Rasterizer.h"
 #include "TextureData.h"
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
 
 typedef struct FT_FaceRec_* FT_Face;
+typedef struct FT_GlyphSlotRec_* FT_GlyphSlot;
+typedef struct FT_LibraryRec_* FT_Library;
 
 namespace ftss
 {
@@ -27,7 +36,8 @@ namespace ftss
         const std::string& filePath,
         unsigned int fontHeightInPixels = 48,
         unsigned int horizontalSpacing = 1,
-        unsigned int verticalSpacing = 1);
+        unsigned int verticalSpacing = 1,
+        long faceIndex = 0);
 
     bool LoadTextureDataAndFontDataFromMemory(
         TextureData& textureData,
@@ -37,20 +47,232 @@ namespace ftss
         size_t dataSize,
         unsigned int fontHeightInPixels = 48,
         unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        long faceIndex = 0);
+
+    // Each character is taken from the first font source in the chain that
+    // has a glyph for it and all glyphs are packed into one texture.
+    // glyphSourceMap receives the index into fontSources that served each
+    // character. Characters no font source has fall back to the .notdef
+    // glyph of fontSources[0]. With a subpixelVariantCount above 1 every
+    // glyph is also rendered shifted right by 1 / subpixelVariantCount,
+    // 2 / subpixelVariantCount and so on of a pixel, see FontData.
+    bool LoadTextureDataAndFontDataFromFontChain(
+        TextureData& textureData,
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources,
+        unsigned int fontHeightInPixels = 48,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        unsigned int subpixelVariantCount = 1,
+        const std::vector<unsigned char>& packOrder = std::vector<unsigned char>());
+
+    // Like LoadTextureDataAndFontDataFromFontChain but glyphs already in
+    // glyphCache aren't rendered again, only the texture is composed anew.
+    // fontData is rebuilt from scratch. Clear glyphCache when the fonts change.
+    bool LoadTextureDataAndFontDataIncremental(
+        TextureData& textureData,
+        FontData& fontData,
+        GlyphCache& glyphCache,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources,
+        unsigned int fontHeightInPixels = 48,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        unsigned int subpixelVariantCount = 1);
+
+    // Bakes up to four fonts or sizes into one texture, the coverage of
+    // channelSources[i] goes into channel i (R, G, B, A) and fontDatas[i]
+    // receives its metrics with every glyph recording that channel. The
+    // channels are packed independently and share the texture size.
+    bool LoadChannelPackedTextureData(
+        TextureData& textureData,
+        std::vector<FontData>& fontDatas,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<ChannelSource>& channelSources,
+        unsigned int horizontalSpacing = 1,
         unsigned int verticalSpacing = 1);
 
+    // Like LoadTextureDataAndFontDataFromFontChain with the effect layers of
+    // effectSettings in the red, green and blue channels and the glyphs in
+    // alpha. Every glyph box grows by effectSettings.GetPadding() on each
+    // side, the metrics are moved so the glyph stays where it was. The
+    // effects of different glyphs are computed on threadCount threads,
+    // 0 uses all hardware threads.
+    bool LoadTextureDataAndFontDataWithEffects(
+        TextureData& textureData,
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources,
+        const EffectSettings& effectSettings,
+        unsigned int fontHeightInPixels = 48,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        unsigned int threadCount = 0,
+        const std::vector<unsigned char>& packOrder = std::vector<unsigned char>());
+
+    // Extracts the outline of every character from the first font source in
+    // the chain that has a glyph for it, in font units with curves flattened
+    // into edges. The outlines can then be rasterized at any size without
+    // FreeType, see LoadTextureDataAndFontDataFromOutlineCache.
+    bool LoadOutlineCache(
+        OutlineCache& outlineCache,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources);
+
+    // Rasterizes the outlines with the native rasterizer, spread over
+    // threadCount threads (0 uses one per hardware thread). The glyphs are
+    // unhinted, so they can differ slightly from LoadTextureDataAndFontData.
+    // fontData is rebuilt from scratch.
+    bool LoadTextureDataAndFontDataFromOutlineCache(
+        TextureData& textureData,
+        FontData& fontData,
+        const OutlineCache& outlineCache,
+        unsigned int fontHeightInPixels = 48,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        unsigned int threadCount = 0,
+        const std::vector<unsigned char>& packOrder = std::vector<unsigned char>());
+
+    // Rasterizes every glyph with both the native rasterizer and FreeType
+    // (unhinted) and compares the coverage pixel by pixel
+    bool CompareWithReferenceRasterizer(
+        RasterizerComparison& rasterizerComparison,
+        const OutlineCache& outlineCache,
+        const std::vector<FontSource>& fontSources,
+        unsigned int fontHeightInPixels = 48,
+        unsigned int threadCount = 0);
+
+    // Fills fontData with the metrics of every character without rendering
+    // anything, the bitmap sizes are taken from the glyph outline bounds.
+    // The texture coordinates are left at 0, see PackFontData.
+    bool LoadFontData(
+        FontData& fontData,
+        const std::vector<unsigned char>& characterList,
+        const std::string& filePath,
+        unsigned int fontHeightInPixels = 48,
+        long faceIndex = 0);
+
+    bool LoadFontDataFromFontChain(
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FontSource>& fontSources,
+        unsigned int fontHeightInPixels = 48);
+
+    // Sets the texture coordinates of every glyph to where
+    // LoadTextureDataAndFontData would place it with the same spacing.
+    // The glyphs of packOrder are placed first and in that order, see
+    // ComputePackOrder, every function that packs glyphs takes it.
+    void PackFontData(
+        FontData& fontData,
+        unsigned int& textureWidth,
+        unsigned int& textureHeight,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        const std::vector<unsigned char>& packOrder = std::vector<unsigned char>());
+
+    // Row of the texture data the top edge of a glyph is in, from its
+    // texture coordinates and whether they are flipped vertically
+    unsigned int GetTextureTopRow(
+        float textureBottom,
+        float textureTop,
+        unsigned int textureHeight);
+
+    // Number of faces in a font file, more than 1 for font collections (.ttc)
+    bool GetFaceCount(
+        long& faceCount,
+        const std::string& filePath);
+
     bool WriteTextureData(
         const TextureData& textureData,
         const std::string& filePath);
 
+    // The Encode functions append to buffer, so several outputs can be
+    // gathered in one buffer. They write exactly what the Write functions
+    // would write to a file.
+
+    bool EncodeTextureData(
+        std::vector<unsigned char>& buffer,
+        const TextureData& textureData);
+
+    // Uncompressed: an 8 byte signature, version, width, height and bytes
+    // per pixel followed by the pixels
+    bool EncodeRawTextureData(
+        std::vector<unsigned char>& buffer,
+        const TextureData& textureData);
+
+    bool DecodeRawTextureData(
+        TextureData& textureData,
+        const unsigned char* dataPtr,
+        size_t dataSize);
+
+    // Writes version 1, version 3 with a channel per glyph when a glyph isn't
+    // in the alpha channel or version 4 when there are subpixel variants
     bool WriteFontData(
         const FontData& fontData,
         const std::string& filePath);
 
+    void EncodeFontData(
+        std::vector<unsigned char>& buffer,
+        const FontData& fontData);
+
+    // Writes a C++ header with the glyph metrics as a constexpr array sorted
+    // by character, a constexpr lookup function and the texture pixels, so
+    // the font can be compiled into a program. Everything is declared inside
+    // namespaceName. Without texture data only the metrics are written.
+    bool WriteFontDataHeader(
+        const FontData& fontData,
+        const TextureData& textureData,
+        const std::string& filePath,
+        const std::string& namespaceName);
+
+    // Reads both the regular and the compact font data file versions
     bool ReadFontData(
         FontData& fontData,
         const std::string& filePath);
 
+    // Decodes both the regular and the compact font data versions
+    bool DecodeFontData(
+        FontData& fontData,
+        const unsigned char* dataPtr,
+        size_t dataSize);
+
+    // Fails if a metric doesn't fit into 16 bits, a glyph isn't in the alpha
+    // channel or there are subpixel variants. Texture coordinates are rounded
+    // to the nearest 1/65535.
+    bool ConvertToCompactFontData(
+        CompactFontData& compactFontData,
+        const FontData& fontData);
+
+    void ConvertFromCompactFontData(
+        FontData& fontData,
+        const CompactFontData& compactFontData);
+
+    bool WriteCompactFontData(
+        const CompactFontData& compactFontData,
+        const std::string& filePath);
+
+    void EncodeCompactFontData(
+        std::vector<unsigned char>& buffer,
+        const CompactFontData& compactFontData);
+
+    // Reads both the regular and the compact font data file versions
+    bool ReadCompactFontData(
+        CompactFontData& compactFontData,
+        const std::string& filePath);
+
+    // Decodes both the regular and the compact font data versions
+    bool DecodeCompactFontData(
+        CompactFontData& compactFontData,
+        const unsigned char* dataPtr,
+        size_t dataSize);
+
     // Used in LoadTextureDataAndFontData and LoadTextureDataAndFontDataFromMemory
     bool LoadTextureDataAndFontData_H(
         TextureData& textureData,
@@ -61,6 +283,238 @@ namespace ftss
         unsigned int horizontalSpacing = 1,
         unsigned int verticalSpacing = 1);
 
+    // Used in LoadTextureDataAndFontData_H and LoadTextureDataAndFontDataFromFontChain
+    bool LoadTextureDataAndFontData_H(
+        TextureData& textureData,
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels = 48,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        unsigned int subpixelVariantCount = 1,
+        const std::vector<unsigned char>& packOrder = std::vector<unsigned char>());
+
+    // Used in LoadTextureDataAndFontData_H and LoadTextureDataAndFontDataIncremental
+    bool LoadTextureDataAndFontData_H(
+        TextureData& textureData,
+        FontData& fontData,
+        GlyphCache& glyphCache,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels = 48,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        unsigned int subpixelVariantCount = 1,
+        const std::vector<unsigned char>& packOrder = std::vector<unsigned char>());
+
+    // Used in LoadTextureDataAndFontData_H and LoadChannelPackedTextureData,
+    // renders the glyphs glyphCache doesn't have yet
+    bool RenderGlyphBitmaps_H(
+        FontData& fontData,
+        GlyphCache& glyphCache,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels = 48,
+        unsigned int subpixelVariantCount = 1);
+
+    // Used in RenderGlyphBitmaps_H
+    bool RenderGlyphBitmap_H(
+        GlyphBitmap& glyphBitmap,
+        FT_Face face,
+        unsigned char character);
+
+    // Used in RenderGlyphBitmaps_H, offsetX is in 1/64 of a pixel
+    bool RenderSubpixelBitmap_H(
+        SubpixelBitmap& subpixelBitmap,
+        FT_Face face,
+        unsigned char character,
+        long offsetX);
+
+    // Used in LoadTextureDataAndFontData_H
+    bool ComposeTextureData_H(
+        TextureData& textureData,
+        FontData& fontData,
+        const std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        const std::vector<unsigned char>& packOrder = std::vector<unsigned char>());
+
+    // Used in LoadChannelPackedTextureData and LoadTextureDataAndFontDataWithEffects,
+    // writes only the glyph coverage into channel and leaves the other channels alone
+    void ComposeTextureChannel_H(
+        TextureData& textureData,
+        const FontData& fontData,
+        const std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap,
+        const std::unordered_map<unsigned char, unsigned int>& glyphOffsetXMap,
+        unsigned int verticalSpacing,
+        unsigned char channel);
+
+    // Used in LoadTextureDataAndFontDataWithEffects, the outside stroke of
+    // the glyph. The metrics of outlineBitmap give the size and position of
+    // the stroke bitmap. stroked is false for glyphs without an outline.
+    bool RenderOutlineBitmap_H(
+        GlyphBitmap& outlineBitmap,
+        bool& stroked,
+        FT_Library library,
+        FT_Face face,
+        unsigned char character,
+        unsigned int radius);
+
+    // Used in LoadTextureDataAndFontDataWithEffects, fills
+    // layerBitmapMaps[channel] with the padded glyphs and their effect layers
+    void ApplyGlyphEffects_H(
+        std::vector<std::unordered_map<unsigned char, GlyphBitmap>>& layerBitmapMaps,
+        const std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap,
+        const std::unordered_map<unsigned char, GlyphBitmap>& outlineBitmapMap,
+        const EffectSettings& effectSettings,
+        unsigned int threadCount);
+
+    // Used in ApplyGlyphEffects_H, copies a width * height bitmap into a
+    // destinationWidth * destinationHeight one at (x, y), cut at the edges
+    void BlitCoverage_H(
+        std::vector<unsigned char>& destination,
+        unsigned int destinationWidth,
+        unsigned int destinationHeight,
+        const std::vector<unsigned char>& source,
+        unsigned int width,
+        unsigned int height,
+        int x,
+        int y);
+
+    // Used in LoadTextureDataAndFontDataFromOutlineCache and CompareWithReferenceRasterizer
+    bool RasterizeOutlineCache_H(
+        std::unordered_map<unsigned char, GlyphBitmap>& glyphBitmapMap,
+        const OutlineCache& outlineCache,
+        unsigned int fontHeightInPixels,
+        unsigned int threadCount);
+
+    // Used in LoadOutlineCache
+    bool LoadGlyphOutline_H(
+        GlyphOutline& glyphOutline,
+        FT_Face face,
+        unsigned char character,
+        float tolerance);
+
+    // Used in LoadFontData and LoadFontDataFromFontChain
+    bool LoadFontData_H(
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels = 48);
+
+    // Used in LoadTextureDataAndFontData_H and LoadFontData_H
+    bool PrepareFontData_H(
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        const std::vector<unsigned char>& characterList,
+        const std::vector<FT_Face>& faces,
+        unsigned int fontHeightInPixels = 48);
+
+    // Used in PrepareFontData_H and LoadOutlineCache
+    void ResolveGlyphSources_H(
+        std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+        std::vector<bool>& faceUsed,
+        const std::vector<unsigned char>& characters,
+        const std::vector<FT_Face>& faces);
+
+    // Used in LoadTextureDataAndFontData_H and LoadFontData_H
+    void SetGlyphMetrics_H(
+        GlyphMetrics& glyphMetrics,
+        FT_GlyphSlot glyph);
+
+    // Used in RasterizeOutlineCache_H, scale is pixels per font unit
+    void SetGlyphMetrics_H(
+        GlyphMetrics& glyphMetrics,
+        const GlyphOutline& glyphOutline,
+        float scale);
+
+    // Used in LoadTextureDataAndFontData_H and PackFontData
+    void PackFontData_H(
+        FontData& fontData,
+        std::unordered_map<unsigned char, unsigned int>& glyphOffsetXMap,
+        unsigned int& textureWidth,
+        unsigned int& textureHeight,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1,
+        const std::vector<unsigned char>& packOrder = std::vector<unsigned char>());
+
+    // Used in PackFontData_H and LoadChannelPackedTextureData
+    void SetTextureCoordinates_H(
+        FontData& fontData,
+        const std::unordered_map<unsigned char, unsigned int>& glyphOffsetXMap,
+        unsigned int textureWidth,
+        unsigned int textureHeight,
+        unsigned int horizontalSpacing = 1,
+        unsigned int verticalSpacing = 1);
+
+    // Used in the functions that load from font sources
+    bool OpenFontSources_H(
+        FT_Library& library,
+        std::vector<FT_Face>& faces,
+        const std::vector<FontSource>& fontSources);
+
+    // Used in the functions that load from font sources
+    void CloseFontSources_H(
+        FT_Library library,
+        std::vector<FT_Face>& faces);
+
+    // Used in DecodeFontData and DecodeCompactFontData
+    bool DecodeFontDataHeader_H(
+        unsigned int& version,
+        const unsigned char* dataPtr,
+        size_t dataSize,
+        size_t& offset);
+
+    // Used in DecodeFontData and DecodeCompactFontData, for versions 1, 3 and 4
+    bool DecodeFontDataBody_H(
+        FontData& fontData,
+        unsigned int version,
+        const unsigned char* dataPtr,
+        size_t dataSize,
+        size_t& offset);
+
+    // Used in DecodeFontData and DecodeCompactFontData
+    bool DecodeCompactFontDataBody_H(
+        CompactFontData& compactFontData,
+        const unsigned char* dataPtr,
+        size_t dataSize,
+        size_t& offset);
+
+    // Used in the Encode functions
+    void AppendBytes_H(
+        std::vector<unsigned char>& buffer,
+        const void* source,
+        size_t size);
+
+    // Used in the Decode functions, the caller checks the size beforehand
+    void ReadBytes_H(
+        void* destination,
+        const unsigned char* dataPtr,
+        size_t& offset,
+        size_t size);
+
+    // Used in EncodeTextureData as the stb_image_write callback
+    void AppendPngData_H(
+        void* context,
+        void* data,
+        int size);
+
+    // Used in the Write functions, replaces the file atomically
+    bool WriteFile_H(
+        const unsigned char* dataPtr,
+        size_t dataSize,
+        const std::string& filePath);
+
+    // Used in the Read functions
+    bool ReadFile_H(
+        std::vector<unsigned char>& buffer,
+        const std::string& filePath);
+
     // Used in LoadTextureDataAndFontData_H
     unsigned int GetTextureIndex_H(
         unsigned int x,
@@ -0,0 +1,81 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include "FontData.h"
+
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // A glyph rendered shifted right by a fraction of a pixel, it has the
+    // height of the unshifted glyph so the coverage is width_px * height_px
+    struct SubpixelBitmap
+    {
+        SubpixelBitmap();
+
+        unsigned int width_px;
+        unsigned int horiBearingX_px;
+        std::vector<unsigned char> coverage;
+    };
+
+    inline SubpixelBitmap::SubpixelBitmap()
+        : width_px(0)
+        , horiBearingX_px(0)
+    {}
+
+    // A rendered glyph, the coverage is width_px * height_px bytes
+    struct GlyphBitmap
+    {
+        GlyphBitmap();
+
+        GlyphMetrics metrics;
+        unsigned int sourceIndex;
+        std::vector<unsigned char> coverage;
+
+        // variants 1 to subpixelVariantCount - 1, see FontData
+        std::vector<SubpixelBitmap> subpixelBitmaps;
+    };
+
+    inline GlyphBitmap::GlyphBitmap()
+        : metrics()
+        , sourceIndex(0)
+    {}
+
+    // Rendered glyphs kept between builds so a rebuild only renders the
+    // characters that were added. It is cleared when the font height or the
+    // number of subpixel variants changes; when the fonts themselves change
+    // the caller has to Clear it.
+    struct GlyphCache
+    {
+        GlyphCache();
+
+        void Clear();
+
+        unsigned int fontHeightInPixels;
+        unsigned int subpixelVariantCount;
+        std::unordered_map<unsigned char, GlyphBitmap> glyphBitmapMap;
+
+        // glyphs the last build had to render, the rest came from the cache
+        unsigned int renderedGlyphCount;
+    };
+
+    inline GlyphCache::GlyphCache()
+        : fontHeightInPixels(0)
+        , subpixelVariantCount(1)
+        , renderedGlyphCount(0)
+    {}
+
+    inline void GlyphCache::Clear()
+    {
+        fontHeightInPixels = 0;
+        subpixelVariantCount = 1;
+        glyphBitmapMap.clear();
+        renderedGlyphCount = 0;
+    }
+}
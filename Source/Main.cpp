@@ -2,16 +2,121 @@
 // @AUTHOR Vik Pandher
 // @DATE 2024-10-30
 
+#include "CorpusLayout.h"
+#include "FileWatcher.h"
+#include "FontBundle.h"
 #include "FontToSpriteSheet.h"
+#include "Pipeline.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sys/stat.h>
 
 
 
+struct Options
+{
+    Options();
+
+    unsigned long faceIndex;
+    std::vector<ftss::FontSource> fallbackSources;
+    bool metricsOnly;
+    bool compact;
+    bool benchmarkLookup;
+    const char* headerFile;
+    bool hugePages;
+    bool watch;
+    bool nativeRaster;
+    unsigned long threadCount;
+    bool compareReference;
+    std::vector<ftss::ChannelSource> channelSources;
+    const char* jobsFile;
+    unsigned long subpixelVariantCount;
+    ftss::EffectSettings effectSettings;
+    std::vector<std::string> corpusFiles;
+    const char* bundleFile;
+};
+
+Options::Options()
+    : faceIndex(0)
+    , metricsOnly(false)
+    , compact(false)
+    , benchmarkLookup(false)
+    , headerFile(nullptr)
+    , hugePages(false)
+    , watch(false)
+    , nativeRaster(false)
+    , threadCount(0)
+    , compareReference(false)
+    , jobsFile(nullptr)
+    , subpixelVariantCount(1)
+    , bundleFile(nullptr)
+{}
+
+bool ParseArguments(int argc, char** argv, std::vector<const char*>& arguments, Options& options);
+bool WriteOutputs(
+    const Options& options,
+    const ftss::TextureData& textureData,
+    const ftss::FontData& fontData,
+    ftss::CompactFontData& compactFontData,
+    const char* output_file_1,
+    const char* output_file_2,
+    const char* header_file);
+bool WriteBundle(
+    const std::vector<ftss::FontBundleSource>& fontBundleSources,
+    const char* bundle_file);
+int RunWatchMode(
+    const Options& options,
+    const std::vector<ftss::FontSource>& fontSources,
+    const char* characterListFile,
+    unsigned int fontSize,
+    unsigned int horizontalSpacing,
+    unsigned int verticalSpacing,
+    const char* output_file_1,
+    const char* output_file_2);
+int RunChannelPackedMode(
+    const Options& options,
+    const std::vector<ftss::FontSource>& fontSources,
+    const std::vector<unsigned char>& characterList,
+    unsigned int fontSize,
+    unsigned int horizontalSpacing,
+    unsigned int verticalSpacing,
+    const char* output_file_1,
+    const char* output_file_2);
+int RunJobs(const Options& options);
+bool LoadJobs(std::vector<ftss::PipelineJob>& jobs, const std::string& filePath);
 int CompareStrings(const char* string1, const char* string2);
 bool FileExists(const std::string& filePath);
 bool ConvertStringToUnsignedInt(const char* string, unsigned long& result);
+bool ConvertStringToInt(const char* string, long& result);
+bool ParseFontSizes(const char* string, std::vector<unsigned int>& result);
+std::string AddFileNameSuffix(const std::string& filePath, const std::string& suffix);
+bool ParseFontSource(const char* string, ftss::FontSource& result);
+void PrintGlyphSources(
+    const std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+    const std::vector<ftss::FontSource>& fontSources);
+void RunLookupBenchmark(
+    const ftss::FontData& fontData,
+    const ftss::CompactFontData& compactFontData,
+    const std::vector<unsigned char>& characterList);
+std::string GetFileStem(const std::string& filePath);
+std::string GetNamespaceName(const std::string& filePath);
+void PrintLocalityReport(
+    const ftss::CorpusStatistics& corpusStatistics,
+    const ftss::FontData& fontData,
+    unsigned int textureWidth,
+    unsigned int textureHeight,
+    unsigned int fontSize,
+    unsigned int horizontalSpacing,
+    unsigned int verticalSpacing);
 
 int main(int argc, char** argv)
 {
@@ -33,7 +138,7 @@ int main(int argc, char** argv)
         }
 
         std::cout << "Usage:" << std::endl;
-        std::cout << "    ./" << PROJECT_NAME << " <size> <horizontal_spacing> <vertical_spacing> <input_file_1> <input_file_2> <output_file_1> <output_file_2>" << std::endl;
+        std::cout << "    ./" << PROJECT_NAME << " <size> <horizontal_spacing> <vertical_spacing> <input_file_1> <input_file_2> <output_file_1> <output_file_2> [options]" << std::endl;
         std::cout << std::endl;
         std::cout << "Description:" << std::endl;
         std::cout << "    This program converts a true type font (.ttf) file and a list of characters" << std::endl;
@@ -41,61 +146,130 @@ int main(int argc, char** argv)
         std::cout << "    portable network graphics (.png) file and a sprite sheet font discription file." << std::endl;
         std::cout << std::endl;
         std::cout << "Parameters:" << std::endl;
-        std::cout << "    <size>                  Font height in pixels" << std::endl;
+        std::cout << "    <size>                  Font height in pixels, a comma separated list bakes every size" << std::endl;
+        std::cout << "                            with _<size> added to the output file names" << std::endl;
         std::cout << "    <horizontal_spacing>    Horizontal spacing between glpyh sprites" << std::endl;
         std::cout << "    <vertical_spacing>      Vertical spacing between glpyh sprites" << std::endl;
         std::cout << "    <input_file_1>          The true type font file (.ttf)" << std::endl;
         std::cout << "    <input_file_2>          The file with a list of characters (.txt)" << std::endl;
         std::cout << "    <output_file_1>         The portable network graphics file (.png)" << std::endl;
         std::cout << "    <output_file_2>         The sprite sheet font discription file" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "    --face <index>          Face of <input_file_1> to use for font collections (.ttc)" << std::endl;
+        std::cout << "    --fallback <file>[,<index>]" << std::endl;
+        std::cout << "                            Font (and face) to take glyphs from that the fonts before" << std::endl;
+        std::cout << "                            it don't have, can be repeated to form a fallback chain" << std::endl;
+        std::cout << "    --metrics-only          Only write <output_file_2>, without rendering any glyphs." << std::endl;
+        std::cout << "                            <output_file_1> is left out of the parameters" << std::endl;
+        std::cout << "    --compact               Write <output_file_2> with 16 bit metrics in a structure of arrays" << std::endl;
+        std::cout << "    --benchmark-lookup      Time glyph lookups in the regular and the compact font data" << std::endl;
+        std::cout << "    --header <file>         Also write the font data and texture as a C++ header (.h) with" << std::endl;
+        std::cout << "                            constexpr arrays in a namespace named after the file" << std::endl;
+        std::cout << "    --huge-pages            Allocate the texture in huge pages where the system allows it" << std::endl;
+        std::cout << "    --watch                 Keep running and rebuild whenever the input files change, only" << std::endl;
+        std::cout << "                            rendering glyphs that were added to the character list" << std::endl;
+        std::cout << "    --native-raster         Extract the glyph outlines once and rasterize every size with" << std::endl;
+        std::cout << "                            the built in SIMD rasterizer instead of FreeType (unhinted)" << std::endl;
+        std::cout << "    --threads <count>       Threads for --native-raster and the effects, 0 uses all" << std::endl;
+        std::cout << "                            hardware threads" << std::endl;
+        std::cout << "    --compare-reference     Report the largest coverage difference between the built in" << std::endl;
+        std::cout << "                            rasterizer and FreeType and the time each takes" << std::endl;
+        std::cout << "    --channel <size> <file>[,<index>]" << std::endl;
+        std::cout << "                            Bake another font or size into the next channel of the same" << std::endl;
+        std::cout << "                            texture, <input_file_1> goes into red, then green, blue and" << std::endl;
+        std::cout << "                            alpha. Up to 3 times, writes <output_file_2> once per channel" << std::endl;
+        std::cout << "                            with _r, _g, _b or _a added to the file name" << std::endl;
+        std::cout << "    --jobs <file>           Build every line of <file> as a job instead of the parameters," << std::endl;
+        std::cout << "                            each line holding all 7 of them (quote paths with spaces)." << std::endl;
+        std::cout << "                            The jobs overlap in a pipeline of load, rasterize, encode" << std::endl;
+        std::cout << "                            and write stages" << std::endl;
+        std::cout << "    --subpixel <count>      Also render every glyph shifted right by 1/<count> to" << std::endl;
+        std::cout << "                            (<count> - 1)/<count> of a pixel next to it in the texture," << std::endl;
+        std::cout << "                            for text placed at fractional positions (up to 64)" << std::endl;
+        std::cout << "    --outline <radius>      Stroke every glyph <radius> pixels wide into the red channel" << std::endl;
+        std::cout << "    --glow <radius>         Glow reaching <radius> pixels around every glyph in green" << std::endl;
+        std::cout << "    --shadow <radius> <offset_x> <offset_y>" << std::endl;
+        std::cout << "                            Shadow blurred by <radius> pixels and moved by the offset" << std::endl;
+        std::cout << "                            (y down) in blue. With any effect the glyphs go into alpha" << std::endl;
+        std::cout << "                            alone and their boxes grow to fit the effects" << std::endl;
+        std::cout << "    --corpus <file>         Text the font will draw, such as string tables. The glyphs it" << std::endl;
+        std::cout << "                            uses most go first in the texture, next to the glyphs they" << std::endl;
+        std::cout << "                            appear next to, and a texture cache estimate is printed." << std::endl;
+        std::cout << "                            Can be repeated" << std::endl;
+        std::cout << "    --bundle <file>         Also write every size into one bundle file that a program maps" << std::endl;
+        std::cout << "                            into memory and reads the fonts from in place, each found by" << std::endl;
+        std::cout << "                            the name of <input_file_1> without the extension and the size." << std::endl;
+        std::cout << "                            With --jobs every job goes into it, so one bundle holds all" << std::endl;
+        std::cout << "                            the fonts and sizes of the build" << std::endl;
         return 0;
     }
 
-    if (argc < 8)
+    std::vector<const char*> arguments;
+    Options options;
+    if (!ParseArguments(argc, argv, arguments, options))
+    {
+        return 1;
+    }
+
+    if (options.jobsFile != nullptr)
+    {
+        if (!arguments.empty())
+        {
+            std::cerr << "ERROR: --jobs takes the parameters from the file, not the command line" << std::endl;
+            return 1;
+        }
+        return RunJobs(options);
+    }
+
+    // without a texture there is no <output_file_1>
+    const size_t argumentCount = options.metricsOnly ? 6 : 7;
+
+    if (arguments.size() < argumentCount)
     {
         std::cerr << "ERROR: Not enough arguments" << std::endl;
         std::cerr << "    Try /? or /help" << std::endl;
         return 1;
     }
 
-    if (argc > 8)
+    if (arguments.size() > argumentCount)
     {
         std::cerr << "ERROR: Too many arguments" << std::endl;
         std::cerr << "    Try /? or /help" << std::endl;
         return 1;
     }
 
-    unsigned long font_size;
-    if (!ConvertStringToUnsignedInt(argv[1], font_size))
+    std::vector<unsigned int> font_sizes;
+    if (!ParseFontSizes(arguments[0], font_sizes))
     {
-        std::cerr << "ERROR: argv[1] must be of type unsigned int" << std::endl;
+        std::cerr << "ERROR: argv[1] must be an unsigned int or a comma separated list of them" << std::endl;
         return 1;
     }
 
-    if (font_size == 0)
+    if (std::find(font_sizes.begin(), font_sizes.end(), 0u) != font_sizes.end())
     {
         std::cerr << "ERROR: argv[1] cannot be 0" << std::endl;
         return 1;
     }
 
     unsigned long horizontal_spacing;
-    if (!ConvertStringToUnsignedInt(argv[2], horizontal_spacing))
+    if (!ConvertStringToUnsignedInt(arguments[1], horizontal_spacing))
     {
         std::cerr << "ERROR: argv[2] must be of type unsigned int" << std::endl;
         return 1;
     }
 
     unsigned long vertical_spacing;
-    if (!ConvertStringToUnsignedInt(argv[3], vertical_spacing))
+    if (!ConvertStringToUnsignedInt(arguments[2], vertical_spacing))
     {
         std::cerr << "ERROR: argv[3] must be of type unsigned int" << std::endl;
         return 1;
     }
 
-    const char* input_file_1 = argv[4];
-    const char* input_file_2= argv[5];
-    const char* output_file_1 = argv[6];
-    const char* output_file_2 = argv[7];
+    const char* input_file_1 = arguments[3];
+    const char* input_file_2 = arguments[4];
+    const char* output_file_1 = options.metricsOnly ? nullptr : arguments[5];
+    const char* output_file_2 = arguments[argumentCount - 1];
 
     if (CompareStrings(input_file_1, input_file_2) == 0)
     {
@@ -103,7 +277,7 @@ int main(int argc, char** argv)
         return 1;
     }
     
-    if (CompareStrings(input_file_1, output_file_1) == 0)
+    if (output_file_1 != nullptr && CompareStrings(input_file_1, output_file_1) == 0)
     {
         std::cerr << "ERROR: argv[4] and argv[6] cannot be the same value" << std::endl;
         return 1;
@@ -111,11 +285,11 @@ int main(int argc, char** argv)
     
     if (CompareStrings(input_file_1, output_file_2) == 0)
     {
-        std::cerr << "ERROR: argv[4] and argv[7] cannot be the same value" << std::endl;
+        std::cerr << "ERROR: argv[4] and argv[" << argumentCount << "] cannot be the same value" << std::endl;
         return 1;
     }
 
-    if (CompareStrings(input_file_2, output_file_1) == 0)
+    if (output_file_1 != nullptr && CompareStrings(input_file_2, output_file_1) == 0)
     {
         std::cerr << "ERROR: argv[5] and argv[6] cannot be the same value" << std::endl;
         return 1;
@@ -123,11 +297,11 @@ int main(int argc, char** argv)
 
     if (CompareStrings(input_file_2, output_file_2) == 0)
     {
-        std::cerr << "ERROR: argv[5] and argv[7] cannot be the same value" << std::endl;
+        std::cerr << "ERROR: argv[5] and argv[" << argumentCount << "] cannot be the same value" << std::endl;
         return 1;
     }
 
-    if (CompareStrings(output_file_1, output_file_2) == 0)
+    if (output_file_1 != nullptr && CompareStrings(output_file_1, output_file_2) == 0)
     {
         std::cerr << "ERROR: argv[6] and argv[7] cannot be the same value" << std::endl;
         return 1;
@@ -164,51 +338,595 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    ftss::TextureData textureData;
-    ftss::FontData fontData;
-    if (!ftss::LoadTextureDataAndFontData(
-        textureData,
-        fontData,
-        characterList,
-        input_file_1,
-        font_size,
-        horizontal_spacing,
-        vertical_spacing))
+    std::vector<ftss::FontSource> font_sources;
+    font_sources.push_back(ftss::FontSource(input_file_1, static_cast<long>(options.faceIndex)));
+    font_sources.insert(font_sources.end(), options.fallbackSources.begin(), options.fallbackSources.end());
+
+    if (options.metricsOnly && (options.nativeRaster || options.compareReference))
     {
-        std::cerr << "ERROR: loading texture data and font data failed" << std::endl;
+        std::cerr << "ERROR: --native-raster and --compare-reference need a texture, not --metrics-only" << std::endl;
         return 1;
     }
 
-    if (!ftss::WriteTextureData(textureData, output_file_1))
+    if (!options.effectSettings.IsEmpty() &&
+        (options.metricsOnly || options.nativeRaster || options.compareReference || options.subpixelVariantCount > 1 || options.watch))
     {
-        std::cerr << "ERROR: writing texture data failed" << std::endl;
+        std::cerr << "ERROR: --outline, --glow and --shadow render with FreeType into a texture, they don't go" << std::endl;
+        std::cerr << "    together with --metrics-only, --native-raster, --compare-reference, --subpixel or --watch" << std::endl;
         return 1;
     }
 
-    if (!ftss::WriteFontData(fontData, output_file_2))
+    if (options.subpixelVariantCount > 1 && (options.metricsOnly || options.compact || options.nativeRaster))
     {
-        std::cerr << "ERROR: writing font data failed" << std::endl;
+        std::cerr << "ERROR: --subpixel renders with FreeType into a texture, it doesn't go together with" << std::endl;
+        std::cerr << "    --metrics-only, --compact or --native-raster" << std::endl;
         return 1;
     }
 
-    ftss::FontData fontData_copy;
-    if (!ftss::ReadFontData(fontData_copy, output_file_2))
+    // the pack order only depends on the characters, every size shares it
+    ftss::CorpusStatistics corpusStatistics;
+    std::vector<unsigned char> packOrder;
+    if (!options.corpusFiles.empty())
     {
-        std::cerr << "ERROR: reading font data failed" << std::endl;
+        if (options.watch || !options.channelSources.empty())
+        {
+            std::cerr << "ERROR: --corpus doesn't go together with --watch or --channel" << std::endl;
+            return 1;
+        }
+        if (!ftss::LoadCorpusStatistics(corpusStatistics, options.corpusFiles))
+        {
+            std::cerr << "ERROR: loading the corpus failed" << std::endl;
+            return 1;
+        }
+        ftss::ComputePackOrder(packOrder, corpusStatistics, characterList);
+    }
+
+    if (options.bundleFile != nullptr && (options.watch || !options.channelSources.empty()))
+    {
+        std::cerr << "ERROR: --bundle doesn't go together with --watch or --channel" << std::endl;
         return 1;
     }
 
-    if (fontData != fontData_copy)
+    if (options.watch)
+    {
+        if (font_sizes.size() > 1 || options.nativeRaster || options.compareReference)
+        {
+            std::cerr << "ERROR: --watch takes a single size and no --native-raster or --compare-reference" << std::endl;
+            return 1;
+        }
+
+        return RunWatchMode(
+            options,
+            font_sources,
+            input_file_2,
+            font_sizes[0],
+            horizontal_spacing,
+            vertical_spacing,
+            output_file_1,
+            output_file_2);
+    }
+
+    if (!options.channelSources.empty())
+    {
+        if (font_sizes.size() > 1 || options.metricsOnly || options.compact || options.nativeRaster ||
+            options.compareReference || options.headerFile != nullptr || options.watch || options.subpixelVariantCount > 1 ||
+            !options.effectSettings.IsEmpty())
+        {
+            std::cerr << "ERROR: --channel takes a single size and none of --metrics-only, --compact," << std::endl;
+            std::cerr << "    --native-raster, --compare-reference, --header, --watch, --subpixel or effects" << std::endl;
+            return 1;
+        }
+
+        return RunChannelPackedMode(
+            options,
+            font_sources,
+            characterList,
+            font_sizes[0],
+            horizontal_spacing,
+            vertical_spacing,
+            output_file_1,
+            output_file_2);
+    }
+
+    // the outlines are extracted once and serve every size
+    ftss::OutlineCache outlineCache;
+    std::unordered_map<unsigned char, unsigned int> glyphSourceMap;
+    if ((options.nativeRaster || options.compareReference) &&
+        !ftss::LoadOutlineCache(outlineCache, glyphSourceMap, characterList, font_sources))
     {
-        std::cerr << "ERROR: font data file check failed" << std::endl;
+        std::cerr << "ERROR: loading glyph outlines failed" << std::endl;
         return 1;
     }
 
-    std::cout << "Successfully generated " << output_file_1 << " and " << output_file_2 << std::endl;
+    ftss::HugePageTextureAllocator hugePageTextureAllocator;
+    ftss::TextureData textureData(options.hugePages ? hugePageTextureAllocator : ftss::GetDefaultTextureAllocator());
+    std::vector<ftss::FontBundleSource> fontBundleSources;
+    for (unsigned int font_size : font_sizes)
+    {
+        // a single size keeps the file names as they were given
+        std::string sized_output_file_1 = output_file_1 != nullptr ? output_file_1 : "";
+        std::string sized_output_file_2 = output_file_2;
+        std::string sized_header_file = options.headerFile != nullptr ? options.headerFile : "";
+        if (font_sizes.size() > 1)
+        {
+            std::string suffix = "_" + std::to_string(font_size);
+            sized_output_file_1 = AddFileNameSuffix(sized_output_file_1, suffix);
+            sized_output_file_2 = AddFileNameSuffix(sized_output_file_2, suffix);
+            sized_header_file = AddFileNameSuffix(sized_header_file, suffix);
+        }
+
+        ftss::FontData fontData;
+        unsigned int textureWidth = 0;
+        unsigned int textureHeight = 0;
+        if (options.metricsOnly)
+        {
+            if (!ftss::LoadFontDataFromFontChain(
+                fontData,
+                glyphSourceMap,
+                characterList,
+                font_sources,
+                font_size))
+            {
+                std::cerr << "ERROR: loading font data failed" << std::endl;
+                return 1;
+            }
+
+            // texture coordinates of the texture a full run would generate
+            ftss::PackFontData(
+                fontData,
+                textureWidth,
+                textureHeight,
+                horizontal_spacing,
+                vertical_spacing,
+                packOrder);
+        }
+        else if (options.nativeRaster)
+        {
+            if (!ftss::LoadTextureDataAndFontDataFromOutlineCache(
+                textureData,
+                fontData,
+                outlineCache,
+                font_size,
+                horizontal_spacing,
+                vertical_spacing,
+                options.threadCount,
+                packOrder))
+            {
+                std::cerr << "ERROR: loading texture data and font data failed" << std::endl;
+                return 1;
+            }
+        }
+        else if (!options.effectSettings.IsEmpty())
+        {
+            if (!ftss::LoadTextureDataAndFontDataWithEffects(
+                textureData,
+                fontData,
+                glyphSourceMap,
+                characterList,
+                font_sources,
+                options.effectSettings,
+                font_size,
+                horizontal_spacing,
+                vertical_spacing,
+                options.threadCount,
+                packOrder))
+            {
+                std::cerr << "ERROR: loading texture data and font data failed" << std::endl;
+                return 1;
+            }
+        }
+        else if (!ftss::LoadTextureDataAndFontDataFromFontChain(
+            textureData,
+            fontData,
+            glyphSourceMap,
+            characterList,
+            font_sources,
+            font_size,
+            horizontal_spacing,
+            vertical_spacing,
+            static_cast<unsigned int>(options.subpixelVariantCount),
+            packOrder))
+        {
+            std::cerr << "ERROR: loading texture data and font data failed" << std::endl;
+            return 1;
+        }
+
+        if (font_sources.size() > 1 && font_size == font_sizes[0])
+        {
+            PrintGlyphSources(glyphSourceMap, font_sources);
+        }
+
+        if (!options.corpusFiles.empty())
+        {
+            if (!options.metricsOnly)
+            {
+                textureWidth = textureData.width;
+                textureHeight = textureData.height;
+            }
+            PrintLocalityReport(corpusStatistics, fontData, textureWidth, textureHeight, font_size, horizontal_spacing, vertical_spacing);
+        }
+
+        if (options.compareReference)
+        {
+            ftss::RasterizerComparison rasterizerComparison;
+            if (!ftss::CompareWithReferenceRasterizer(rasterizerComparison, outlineCache, font_sources, font_size, options.threadCount))
+            {
+                std::cerr << "ERROR: comparing with the reference rasterizer failed" << std::endl;
+                return 1;
+            }
+
+            std::cout << "Reference comparison at " << font_size << " px (" << rasterizerComparison.glyphCount << " glyphs):" << std::endl;
+            std::cout << "    Max difference:  " << rasterizerComparison.maxDifference << "/255";
+            if (rasterizerComparison.maxDifference > 0)
+            {
+                std::cout << " at \"" << rasterizerComparison.maxDifferenceCharacter << "\"";
+            }
+            std::cout << std::endl;
+            std::cout << "    Mean difference: " << rasterizerComparison.meanDifference << "/255" << std::endl;
+            std::cout << "    Native:          " << rasterizerComparison.nativeTime_ms << " ms" << std::endl;
+            std::cout << "    FreeType:        " << rasterizerComparison.referenceTime_ms << " ms" << std::endl;
+            std::cout << "    Speedup:         " << rasterizerComparison.referenceTime_ms / rasterizerComparison.nativeTime_ms << "x" << std::endl;
+        }
+
+        ftss::CompactFontData compactFontData;
+        if (!WriteOutputs(
+            options,
+            textureData,
+            fontData,
+            compactFontData,
+            output_file_1 != nullptr ? sized_output_file_1.c_str() : nullptr,
+            sized_output_file_2.c_str(),
+            options.headerFile != nullptr ? sized_header_file.c_str() : nullptr))
+        {
+            return 1;
+        }
+
+        if (options.benchmarkLookup)
+        {
+            RunLookupBenchmark(fontData, compactFontData, characterList);
+        }
+
+        if (output_file_1 != nullptr)
+        {
+            std::cout << "Successfully generated " << sized_output_file_1 << " and " << sized_output_file_2 << std::endl;
+        }
+        else
+        {
+            std::cout << "Successfully generated " << sized_output_file_2 << std::endl;
+        }
+
+        // the bundle takes the texture over, the next size allocates its own
+        if (options.bundleFile != nullptr)
+        {
+            fontBundleSources.emplace_back();
+            ftss::FontBundleSource& fontBundleSource = fontBundleSources.back();
+            fontBundleSource.fontName = GetFileStem(input_file_1);
+            fontBundleSource.fontSize_px = font_size;
+            fontBundleSource.fontData = fontData;
+            fontBundleSource.textureData = std::move(textureData);
+        }
+    }
+
+    if (options.bundleFile != nullptr)
+    {
+        if (!WriteBundle(fontBundleSources, options.bundleFile))
+        {
+            return 1;
+        }
+        std::cout << "Successfully generated " << options.bundleFile << " with " << fontBundleSources.size() << " fonts" << std::endl;
+    }
 
     return 0;
 }
 
+bool WriteOutputs(
+    const Options& options,
+    const ftss::TextureData& textureData,
+    const ftss::FontData& fontData,
+    ftss::CompactFontData& compactFontData,
+    const char* output_file_1,
+    const char* output_file_2,
+    const char* header_file)
+{
+    if (output_file_1 != nullptr && !ftss::WriteTextureData(textureData, output_file_1))
+    {
+        std::cerr << "ERROR: writing texture data failed" << std::endl;
+        return false;
+    }
+
+    if ((options.compact || options.benchmarkLookup) &&
+        !ftss::ConvertToCompactFontData(compactFontData, fontData))
+    {
+        std::cerr << "ERROR: converting to compact font data failed" << std::endl;
+        return false;
+    }
+
+    if (options.compact)
+    {
+        if (!ftss::WriteCompactFontData(compactFontData, output_file_2))
+        {
+            std::cerr << "ERROR: writing font data failed" << std::endl;
+            return false;
+        }
+
+        ftss::CompactFontData compactFontData_copy;
+        if (!ftss::ReadCompactFontData(compactFontData_copy, output_file_2))
+        {
+            std::cerr << "ERROR: reading font data failed" << std::endl;
+            return false;
+        }
+
+        if (compactFontData != compactFontData_copy)
+        {
+            std::cerr << "ERROR: font data file check failed" << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        if (!ftss::WriteFontData(fontData, output_file_2))
+        {
+            std::cerr << "ERROR: writing font data failed" << std::endl;
+            return false;
+        }
+
+        ftss::FontData fontData_copy;
+        if (!ftss::ReadFontData(fontData_copy, output_file_2))
+        {
+            std::cerr << "ERROR: reading font data failed" << std::endl;
+            return false;
+        }
+
+        if (fontData != fontData_copy)
+        {
+            std::cerr << "ERROR: font data file check failed" << std::endl;
+            return false;
+        }
+    }
+
+    if (header_file != nullptr &&
+        !ftss::WriteFontDataHeader(fontData, textureData, header_file, GetNamespaceName(header_file)))
+    {
+        std::cerr << "ERROR: writing font data header failed" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool WriteBundle(
+    const std::vector<ftss::FontBundleSource>& fontBundleSources,
+    const char* bundle_file)
+{
+    if (!ftss::WriteFontBundle(fontBundleSources, bundle_file))
+    {
+        std::cerr << "ERROR: writing font bundle failed" << std::endl;
+        return false;
+    }
+
+    // read back through the mapping like a program would
+    ftss::FontBundle fontBundle;
+    if (!fontBundle.Open(bundle_file))
+    {
+        std::cerr << "ERROR: reading font bundle failed" << std::endl;
+        return false;
+    }
+
+    for (const ftss::FontBundleSource& fontBundleSource : fontBundleSources)
+    {
+        ftss::FontBundleView fontBundleView;
+        ftss::FontData fontData_copy;
+        if (fontBundle.FindFont(fontBundleView, fontBundleSource.fontName, fontBundleSource.fontSize_px))
+        {
+            ftss::ConvertFromFontBundleView(fontData_copy, fontBundleView);
+        }
+
+        const ftss::TextureData& textureData = fontBundleSource.textureData;
+        if (fontBundleView.fontName == nullptr ||
+            fontData_copy != fontBundleSource.fontData ||
+            fontBundleView.textureWidth != textureData.width ||
+            fontBundleView.textureHeight != textureData.height ||
+            (textureData.GetSize() != 0 && std::memcmp(fontBundleView.textureData, textureData.data, textureData.GetSize()) != 0))
+        {
+            std::cerr << "ERROR: font bundle file check failed" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ParseArguments(int argc, char** argv, std::vector<const char*>& arguments, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i][0] != '-' || argv[i][1] != '-')
+        {
+            arguments.push_back(argv[i]);
+        }
+        else if (CompareStrings(argv[i], "--face") == 0)
+        {
+            if (i + 1 >= argc || !ConvertStringToUnsignedInt(argv[i + 1], options.faceIndex))
+            {
+                std::cerr << "ERROR: --face must be followed by an unsigned int" << std::endl;
+                return false;
+            }
+            ++i;
+        }
+        else if (CompareStrings(argv[i], "--fallback") == 0)
+        {
+            ftss::FontSource fallbackSource;
+            if (i + 1 >= argc || !ParseFontSource(argv[i + 1], fallbackSource))
+            {
+                std::cerr << "ERROR: --fallback must be followed by <file>[,<index>]" << std::endl;
+                return false;
+            }
+            if (!FileExists(fallbackSource.filePath))
+            {
+                std::cerr << "ERROR: --fallback, file doesn't exist: " << fallbackSource.filePath << std::endl;
+                return false;
+            }
+            options.fallbackSources.push_back(fallbackSource);
+            ++i;
+        }
+        else if (CompareStrings(argv[i], "--metrics-only") == 0)
+        {
+            options.metricsOnly = true;
+        }
+        else if (CompareStrings(argv[i], "--compact") == 0)
+        {
+            options.compact = true;
+        }
+        else if (CompareStrings(argv[i], "--benchmark-lookup") == 0)
+        {
+            options.benchmarkLookup = true;
+        }
+        else if (CompareStrings(argv[i], "--watch") == 0)
+        {
+            options.watch = true;
+        }
+        else if (CompareStrings(argv[i], "--huge-pages") == 0)
+        {
+            options.hugePages = true;
+        }
+        else if (CompareStrings(argv[i], "--native-raster") == 0)
+        {
+            options.nativeRaster = true;
+        }
+        else if (CompareStrings(argv[i], "--compare-reference") == 0)
+        {
+            options.compareReference = true;
+        }
+        else if (CompareStrings(argv[i], "--threads") == 0)
+        {
+            if (i + 1 >= argc || !ConvertStringToUnsignedInt(argv[i + 1], options.threadCount))
+            {
+                std::cerr << "ERROR: --threads must be followed by an unsigned int" << std::endl;
+                return false;
+            }
+            ++i;
+        }
+        else if (CompareStrings(argv[i], "--channel") == 0)
+        {
+            unsigned long fontSize;
+            ftss::FontSource channelSource;
+            if (i + 2 >= argc ||
+                !ConvertStringToUnsignedInt(argv[i + 1], fontSize) || fontSize == 0 ||
+                !ParseFontSource(argv[i + 2], channelSource))
+            {
+                std::cerr << "ERROR: --channel must be followed by <size> <file>[,<index>]" << std::endl;
+                return false;
+            }
+            if (!FileExists(channelSource.filePath))
+            {
+                std::cerr << "ERROR: --channel, file doesn't exist: " << channelSource.filePath << std::endl;
+                return false;
+            }
+            if (options.channelSources.size() == 3)
+            {
+                std::cerr << "ERROR: --channel can be given at most 3 times" << std::endl;
+                return false;
+            }
+            options.channelSources.push_back(ftss::ChannelSource(std::vector<ftss::FontSource>(1, channelSource), static_cast<unsigned int>(fontSize)));
+            i += 2;
+        }
+        else if (CompareStrings(argv[i], "--jobs") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "ERROR: --jobs must be followed by a file" << std::endl;
+                return false;
+            }
+            options.jobsFile = argv[i + 1];
+            ++i;
+        }
+        else if (CompareStrings(argv[i], "--subpixel") == 0)
+        {
+            if (i + 1 >= argc || !ConvertStringToUnsignedInt(argv[i + 1], options.subpixelVariantCount) ||
+                options.subpixelVariantCount == 0 || options.subpixelVariantCount > ftss::FontData::MAX_SUBPIXEL_VARIANT_COUNT)
+            {
+                std::cerr << "ERROR: --subpixel must be followed by a count from 1 to " << ftss::FontData::MAX_SUBPIXEL_VARIANT_COUNT << std::endl;
+                return false;
+            }
+            ++i;
+        }
+        else if (CompareStrings(argv[i], "--outline") == 0 || CompareStrings(argv[i], "--glow") == 0)
+        {
+            unsigned long radius;
+            if (i + 1 >= argc || !ConvertStringToUnsignedInt(argv[i + 1], radius) || radius > ftss::EffectSettings::MAX_RADIUS_PX)
+            {
+                std::cerr << "ERROR: " << argv[i] << " must be followed by a radius up to " << ftss::EffectSettings::MAX_RADIUS_PX << std::endl;
+                return false;
+            }
+            if (CompareStrings(argv[i], "--outline") == 0)
+            {
+                options.effectSettings.outlineRadius_px = static_cast<unsigned int>(radius);
+            }
+            else
+            {
+                options.effectSettings.glowRadius_px = static_cast<unsigned int>(radius);
+            }
+            ++i;
+        }
+        else if (CompareStrings(argv[i], "--shadow") == 0)
+        {
+            const long MAX_RADIUS = static_cast<long>(ftss::EffectSettings::MAX_RADIUS_PX);
+            unsigned long radius;
+            long offsetX;
+            long offsetY;
+            if (i + 3 >= argc ||
+                !ConvertStringToUnsignedInt(argv[i + 1], radius) || radius > ftss::EffectSettings::MAX_RADIUS_PX ||
+                !ConvertStringToInt(argv[i + 2], offsetX) || offsetX < -MAX_RADIUS || offsetX > MAX_RADIUS ||
+                !ConvertStringToInt(argv[i + 3], offsetY) || offsetY < -MAX_RADIUS || offsetY > MAX_RADIUS)
+            {
+                std::cerr << "ERROR: --shadow must be followed by <radius> <offset_x> <offset_y>, each up to " << MAX_RADIUS << std::endl;
+                return false;
+            }
+            options.effectSettings.shadowRadius_px = static_cast<unsigned int>(radius);
+            options.effectSettings.shadowOffsetX_px = static_cast<int>(offsetX);
+            options.effectSettings.shadowOffsetY_px = static_cast<int>(offsetY);
+            i += 3;
+        }
+        else if (CompareStrings(argv[i], "--corpus") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "ERROR: --corpus must be followed by a file" << std::endl;
+                return false;
+            }
+            options.corpusFiles.push_back(argv[i + 1]);
+            ++i;
+        }
+        else if (CompareStrings(argv[i], "--bundle") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "ERROR: --bundle must be followed by a file" << std::endl;
+                return false;
+            }
+            options.bundleFile = argv[i + 1];
+            ++i;
+        }
+        else if (CompareStrings(argv[i], "--header") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "ERROR: --header must be followed by a file" << std::endl;
+                return false;
+            }
+            options.headerFile = argv[i + 1];
+            ++i;
+        }
+        else
+        {
+            std::cerr << "ERROR: Unknown option: " << argv[i] << std::endl;
+            std::cerr << "    Try /? or /help" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 int CompareStrings(const char* string1, const char* string2)
 {
     while (*string1 != '\0' && *string2 != '\0' && *string1 == *string2)
@@ -257,4 +975,550 @@ bool ConvertStringToUnsignedInt(const char* string, unsigned long& result)
 
     result = value;
     return true;
+}
+
+bool ConvertStringToInt(const char* string, long& result)
+{
+    errno = 0;
+
+    char* end;
+    long value = std::strtol(string, &end, 10);
+
+    // Checking for conversion errors
+    if (errno == ERANGE)
+    {
+        std::cerr << "ERROR: Value out of range for long: " << string << std::endl;
+        return false;
+    }
+    else if (*end != '\0' || end == string)
+    {
+        std::cerr << "ERROR: Invalid number: " << string << std::endl;
+        return false;
+    }
+    else if (value > std::numeric_limits<int>::max() || value < std::numeric_limits<int>::min())
+    {
+        std::cerr << "ERROR: Value doesn't fit into an int: " << string << std::endl;
+        return false;
+    }
+
+    result = value;
+    return true;
+}
+
+bool ParseFontSizes(const char* string, std::vector<unsigned int>& result)
+{
+    result.clear();
+    std::string value(string);
+    size_t start = 0;
+    while (true)
+    {
+        size_t comma = value.find(',', start);
+        std::string item = value.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        unsigned long fontSize;
+        if (item.empty() || !ConvertStringToUnsignedInt(item.c_str(), fontSize))
+        {
+            return false;
+        }
+        if (std::find(result.begin(), result.end(), fontSize) == result.end())
+        {
+            result.push_back(static_cast<unsigned int>(fontSize));
+        }
+        if (comma == std::string::npos)
+        {
+            return true;
+        }
+        start = comma + 1;
+    }
+}
+
+std::string AddFileNameSuffix(const std::string& filePath, const std::string& suffix)
+{
+    // "dir/name.ext" becomes "dir/name<suffix>.ext"
+    size_t nameStart = filePath.find_last_of("/\\");
+    nameStart = nameStart == std::string::npos ? 0 : nameStart + 1;
+    size_t extension = filePath.find_last_of('.');
+    if (extension == std::string::npos || extension < nameStart)
+    {
+        extension = filePath.size();
+    }
+    return filePath.substr(0, extension) + suffix + filePath.substr(extension);
+}
+
+bool ParseFontSource(const char* string, ftss::FontSource& result)
+{
+    // "<file>,<index>" selects a face of a font collection, only a trailing
+    // all digit suffix counts so commas in the file name still work
+    std::string value(string);
+    size_t comma = value.find_last_of(',');
+    if (comma != std::string::npos && comma + 1 < value.size() &&
+        value.find_first_not_of("0123456789", comma + 1) == std::string::npos)
+    {
+        unsigned long faceIndex;
+        if (!ConvertStringToUnsignedInt(value.c_str() + comma + 1, faceIndex))
+        {
+            return false;
+        }
+        result.filePath = value.substr(0, comma);
+        result.faceIndex = static_cast<long>(faceIndex);
+    }
+    else
+    {
+        result.filePath = value;
+        result.faceIndex = 0;
+    }
+    return !result.filePath.empty();
+}
+
+void PrintGlyphSources(
+    const std::unordered_map<unsigned char, unsigned int>& glyphSourceMap,
+    const std::vector<ftss::FontSource>& fontSources)
+{
+    std::vector<std::string> characters(fontSources.size());
+    for (const auto& pair : glyphSourceMap)
+    {
+        characters[pair.second].push_back(static_cast<char>(pair.first));
+    }
+
+    std::cout << "Glyph sources:" << std::endl;
+    for (size_t i = 0; i < fontSources.size(); ++i)
+    {
+        std::sort(characters[i].begin(), characters[i].end());
+        std::cout << "    [" << i << "] " << fontSources[i].filePath << " (face " << fontSources[i].faceIndex << "): ";
+        std::cout << characters[i].size() << " glyphs \"" << characters[i] << "\"" << std::endl;
+    }
+}
+
+void RunLookupBenchmark(
+    const ftss::FontData& fontData,
+    const ftss::CompactFontData& compactFontData,
+    const std::vector<unsigned char>& characterList)
+{
+    if (characterList.empty())
+    {
+        return;
+    }
+
+    // pseudo random text over the character list, the same for both layouts
+    const size_t TEXT_LENGTH = 1 << 20;
+    const unsigned int PASS_COUNT = 16;
+    std::vector<unsigned char> text(TEXT_LENGTH);
+    unsigned int state = 12345;
+    for (size_t i = 0; i < TEXT_LENGTH; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        text[i] = characterList[(state >> 8) % characterList.size()];
+    }
+
+    // reads what a renderer needs to place one quad per character
+    float mapSum = 0.0f;
+    auto mapStart = std::chrono::steady_clock::now();
+    for (unsigned int pass = 0; pass < PASS_COUNT; ++pass)
+    {
+        for (unsigned char c : text)
+        {
+            auto it = fontData.glyphMetricsMap.find(c);
+            if (it == fontData.glyphMetricsMap.end())
+            {
+                continue;
+            }
+            const ftss::GlyphMetrics& metrics = it->second;
+            mapSum += static_cast<float>(metrics.width_px + metrics.height_px + metrics.horiBearingX_px + metrics.horiBearingY_px + metrics.horiAdvance_px);
+            mapSum += metrics.textureLeft + metrics.textureRight + metrics.textureBottom + metrics.textureTop;
+        }
+    }
+    auto mapEnd = std::chrono::steady_clock::now();
+
+    const float NORMALIZED_SCALE = 1.0f / 65535.0f;
+    float compactSum = 0.0f;
+    auto compactStart = std::chrono::steady_clock::now();
+    for (unsigned int pass = 0; pass < PASS_COUNT; ++pass)
+    {
+        for (unsigned char c : text)
+        {
+            unsigned short slot = compactFontData.GetSlot(c);
+            if (slot == ftss::CompactFontData::INVALID_SLOT)
+            {
+                continue;
+            }
+            compactSum += static_cast<float>(compactFontData.width_px[slot] + compactFontData.height_px[slot] + compactFontData.horiBearingX_px[slot] + compactFontData.horiBearingY_px[slot] + compactFontData.horiAdvance_px[slot]);
+            compactSum += (compactFontData.textureLeft[slot] + compactFontData.textureRight[slot] + compactFontData.textureBottom[slot] + compactFontData.textureTop[slot]) * NORMALIZED_SCALE;
+        }
+    }
+    auto compactEnd = std::chrono::steady_clock::now();
+
+    double lookupCount = static_cast<double>(TEXT_LENGTH) * PASS_COUNT;
+    double mapTime_ns = std::chrono::duration<double, std::nano>(mapEnd - mapStart).count() / lookupCount;
+    double compactTime_ns = std::chrono::duration<double, std::nano>(compactEnd - compactStart).count() / lookupCount;
+
+    size_t mapSize = fontData.glyphMetricsMap.size() * (sizeof(unsigned char) + sizeof(ftss::GlyphMetrics));
+    size_t compactSize = sizeof(compactFontData.slotMap) + compactFontData.GetGlyphCount() * (1 + 12 * sizeof(unsigned short));
+
+    std::cout << "Lookup benchmark (" << TEXT_LENGTH * PASS_COUNT << " lookups):" << std::endl;
+    std::cout << "    FontData:        " << mapTime_ns << " ns/lookup, " << mapSize << " bytes of metrics (checksum " << mapSum << ")" << std::endl;
+    std::cout << "    CompactFontData: " << compactTime_ns << " ns/lookup, " << compactSize << " bytes of metrics (checksum " << compactSum << ")" << std::endl;
+    std::cout << "    Speedup:         " << mapTime_ns / compactTime_ns << "x" << std::endl;
+}
+
+std::string GetFileStem(const std::string& filePath)
+{
+    // file name without directories and extension
+    size_t nameStart = filePath.find_last_of("/\\");
+    nameStart = nameStart == std::string::npos ? 0 : nameStart + 1;
+    size_t nameEnd = filePath.find_last_of('.');
+    if (nameEnd == std::string::npos || nameEnd < nameStart)
+    {
+        nameEnd = filePath.size();
+    }
+
+    return filePath.substr(nameStart, nameEnd - nameStart);
+}
+
+std::string GetNamespaceName(const std::string& filePath)
+{
+    // the file stem made into an identifier
+    std::string name = GetFileStem(filePath);
+    for (char& c : name)
+    {
+        if (!std::isalnum(static_cast<unsigned char>(c)))
+        {
+            c = '_';
+        }
+    }
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])))
+    {
+        name.insert(0, "font_");
+    }
+    return name;
+}
+
+int RunWatchMode(
+    const Options& options,
+    const std::vector<ftss::FontSource>& fontSources,
+    const char* characterListFile,
+    unsigned int fontSize,
+    unsigned int horizontalSpacing,
+    unsigned int verticalSpacing,
+    const char* output_file_1,
+    const char* output_file_2)
+{
+    ftss::FileWatcher fileWatcher;
+    for (const ftss::FontSource& fontSource : fontSources)
+    {
+        if (!fileWatcher.AddFile(fontSource.filePath))
+        {
+            return 1;
+        }
+    }
+    if (!fileWatcher.AddFile(characterListFile))
+    {
+        return 1;
+    }
+
+    ftss::HugePageTextureAllocator hugePageTextureAllocator;
+    ftss::TextureData textureData(options.hugePages ? hugePageTextureAllocator : ftss::GetDefaultTextureAllocator());
+    ftss::GlyphCache glyphCache;
+
+    bool reloadCharacterList = true;
+    std::vector<unsigned char> characterList;
+    std::vector<std::string> changedFiles;
+    while (true)
+    {
+        // a failed build keeps the previous outputs and waits for the next change
+        bool built = true;
+        if (reloadCharacterList && !ftss::LoadCharacterListFromFile(characterList, characterListFile))
+        {
+            std::cerr << "ERROR: loading character list failed" << std::endl;
+            built = false;
+        }
+
+        ftss::FontData fontData;
+        std::unordered_map<unsigned char, unsigned int> glyphSourceMap;
+        if (built && options.metricsOnly)
+        {
+            built = ftss::LoadFontDataFromFontChain(fontData, glyphSourceMap, characterList, fontSources, fontSize);
+            if (built)
+            {
+                unsigned int textureWidth;
+                unsigned int textureHeight;
+                ftss::PackFontData(fontData, textureWidth, textureHeight, horizontalSpacing, verticalSpacing);
+            }
+        }
+        else if (built)
+        {
+            built = ftss::LoadTextureDataAndFontDataIncremental(
+                textureData,
+                fontData,
+                glyphCache,
+                glyphSourceMap,
+                characterList,
+                fontSources,
+                fontSize,
+                horizontalSpacing,
+                verticalSpacing,
+                static_cast<unsigned int>(options.subpixelVariantCount));
+        }
+
+        ftss::CompactFontData compactFontData;
+        if (built && WriteOutputs(options, textureData, fontData, compactFontData, output_file_1, output_file_2, options.headerFile))
+        {
+            std::cout << "Rebuilt " << fontData.glyphMetricsMap.size() << " glyphs, ";
+            std::cout << glyphCache.renderedGlyphCount << " rendered and ";
+            std::cout << fontData.glyphMetricsMap.size() - glyphCache.renderedGlyphCount << " reused" << std::endl;
+        }
+        else
+        {
+            std::cerr << "ERROR: rebuilding failed, waiting for the next change" << std::endl;
+        }
+
+        std::cout << "Watching for changes..." << std::endl;
+        if (!fileWatcher.WaitForChanges(changedFiles))
+        {
+            return 1;
+        }
+
+        reloadCharacterList = false;
+        for (const std::string& changedFile : changedFiles)
+        {
+            std::cout << "Changed: " << changedFile << std::endl;
+            if (changedFile == characterListFile)
+            {
+                reloadCharacterList = true;
+            }
+            else
+            {
+                // the rendered glyphs belong to the old font
+                glyphCache.Clear();
+            }
+        }
+    }
+}
+
+int RunChannelPackedMode(
+    const Options& options,
+    const std::vector<ftss::FontSource>& fontSources,
+    const std::vector<unsigned char>& characterList,
+    unsigned int fontSize,
+    unsigned int horizontalSpacing,
+    unsigned int verticalSpacing,
+    const char* output_file_1,
+    const char* output_file_2)
+{
+    // the fonts from the parameters, with their fallbacks, fill the red channel
+    std::vector<ftss::ChannelSource> channelSources;
+    channelSources.push_back(ftss::ChannelSource(fontSources, fontSize));
+    channelSources.insert(channelSources.end(), options.channelSources.begin(), options.channelSources.end());
+
+    ftss::HugePageTextureAllocator hugePageTextureAllocator;
+    ftss::TextureData textureData(options.hugePages ? hugePageTextureAllocator : ftss::GetDefaultTextureAllocator());
+    std::vector<ftss::FontData> fontDatas;
+    if (!ftss::LoadChannelPackedTextureData(
+        textureData,
+        fontDatas,
+        characterList,
+        channelSources,
+        horizontalSpacing,
+        verticalSpacing))
+    {
+        std::cerr << "ERROR: loading channel packed texture data failed" << std::endl;
+        return 1;
+    }
+
+    const char* CHANNEL_SUFFIXES[] = { "_r", "_g", "_b", "_a" };
+    std::cout << "Channels of " << output_file_1 << " (" << textureData.width << "x" << textureData.height << "):" << std::endl;
+    for (size_t i = 0; i < fontDatas.size(); ++i)
+    {
+        // the texture only has to be written once
+        std::string channel_output_file_2 = AddFileNameSuffix(output_file_2, CHANNEL_SUFFIXES[i]);
+        ftss::CompactFontData compactFontData;
+        if (!WriteOutputs(
+            options,
+            textureData,
+            fontDatas[i],
+            compactFontData,
+            i == 0 ? output_file_1 : nullptr,
+            channel_output_file_2.c_str(),
+            nullptr))
+        {
+            return 1;
+        }
+
+        const ftss::ChannelSource& channelSource = channelSources[i];
+        std::cout << "    " << "RGBA"[i] << ": " << channelSource.fontSources[0].filePath << " at " << channelSource.fontHeightInPixels << " px, ";
+        std::cout << channel_output_file_2 << std::endl;
+    }
+
+    std::cout << "Successfully generated " << output_file_1 << " and " << fontDatas.size() << " font data files" << std::endl;
+
+    return 0;
+}
+
+int RunJobs(const Options& options)
+{
+    if (options.metricsOnly || options.headerFile != nullptr || options.watch || options.nativeRaster ||
+        options.compareReference || !options.channelSources.empty() || !options.fallbackSources.empty() ||
+        options.faceIndex != 0 || options.benchmarkLookup || options.hugePages || options.subpixelVariantCount > 1 ||
+        !options.effectSettings.IsEmpty() || !options.corpusFiles.empty())
+    {
+        std::cerr << "ERROR: --jobs only goes together with --compact and --bundle" << std::endl;
+        return 1;
+    }
+
+    std::vector<ftss::PipelineJob> jobs;
+    if (!LoadJobs(jobs, options.jobsFile))
+    {
+        return 1;
+    }
+
+    ftss::PipelineReport pipelineReport;
+    std::vector<ftss::FontBundleSource> fontBundleSources;
+    bool result = ftss::RunPipeline(
+        pipelineReport,
+        jobs,
+        options.compact,
+        options.bundleFile != nullptr ? &fontBundleSources : nullptr);
+
+    std::cout << "Pipeline: " << pipelineReport.builtJobCount << " built, " << pipelineReport.failedJobCount << " failed in ";
+    std::cout << pipelineReport.wallTime_ms << " ms" << std::endl;
+    for (const ftss::PipelineStageReport& stageReport : pipelineReport.stageReports)
+    {
+        double utilization = pipelineReport.wallTime_ms > 0.0 ? 100.0 * stageReport.busyTime_ms / pipelineReport.wallTime_ms : 0.0;
+        std::cout << "    " << stageReport.name << std::string(12 - stageReport.name.size(), ' ');
+        std::cout << utilization << "% busy (" << stageReport.busyTime_ms << " ms), ";
+        std::cout << stageReport.starvedTime_ms << " ms starved, " << stageReport.blockedTime_ms << " ms blocked" << std::endl;
+    }
+
+    // a bundle missing the fonts of failed jobs would only fail later, in the program using it
+    if (result && options.bundleFile != nullptr)
+    {
+        if (!WriteBundle(fontBundleSources, options.bundleFile))
+        {
+            return 1;
+        }
+        std::cout << "Successfully generated " << options.bundleFile << " with " << fontBundleSources.size() << " fonts" << std::endl;
+    }
+
+    return result ? 0 : 1;
+}
+
+bool LoadJobs(std::vector<ftss::PipelineJob>& jobs, const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open())
+    {
+        std::cerr << "ERROR: could not open the jobs file: " << filePath << std::endl;
+        return false;
+    }
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        // whitespace separated, double quotes keep a value with spaces together
+        std::vector<std::string> values;
+        bool quoted = false;
+        bool inValue = false;
+        for (char c : line)
+        {
+            if (c == '"')
+            {
+                quoted = !quoted;
+                if (!inValue)
+                {
+                    values.push_back(std::string());
+                    inValue = true;
+                }
+            }
+            else if (!quoted && std::isspace(static_cast<unsigned char>(c)))
+            {
+                inValue = false;
+            }
+            else
+            {
+                if (!inValue)
+                {
+                    values.push_back(std::string());
+                    inValue = true;
+                }
+                values.back().push_back(c);
+            }
+        }
+
+        // blank lines and comments
+        if (values.empty() || values[0][0] == '#')
+        {
+            continue;
+        }
+
+        ftss::PipelineJob job;
+        unsigned long fontSize;
+        unsigned long horizontalSpacing;
+        unsigned long verticalSpacing;
+        if (values.size() != 7 || quoted ||
+            !ConvertStringToUnsignedInt(values[0].c_str(), fontSize) || fontSize == 0 ||
+            !ConvertStringToUnsignedInt(values[1].c_str(), horizontalSpacing) ||
+            !ConvertStringToUnsignedInt(values[2].c_str(), verticalSpacing) ||
+            !ParseFontSource(values[3].c_str(), job.fontSource))
+        {
+            std::cerr << "ERROR: " << filePath << ":" << lineNumber << " must be <size> <horizontal_spacing> <vertical_spacing> ";
+            std::cerr << "<input_file_1>[,<index>] <input_file_2> <output_file_1> <output_file_2>" << std::endl;
+            return false;
+        }
+
+        job.fontHeightInPixels = static_cast<unsigned int>(fontSize);
+        job.horizontalSpacing = static_cast<unsigned int>(horizontalSpacing);
+        job.verticalSpacing = static_cast<unsigned int>(verticalSpacing);
+        job.characterListFile = values[4];
+        job.textureFile = values[5];
+        job.fontDataFile = values[6];
+        job.fontName = GetFileStem(job.fontSource.filePath);
+        jobs.push_back(job);
+    }
+
+    if (jobs.empty())
+    {
+        std::cerr << "ERROR: no jobs in " << filePath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void PrintLocalityReport(
+    const ftss::CorpusStatistics& corpusStatistics,
+    const ftss::FontData& fontData,
+    unsigned int textureWidth,
+    unsigned int textureHeight,
+    unsigned int fontSize,
+    unsigned int horizontalSpacing,
+    unsigned int verticalSpacing)
+{
+    // the same glyphs packed the way they would be without a corpus
+    ftss::FontData mapOrderFontData = fontData;
+    unsigned int mapOrderTextureWidth;
+    unsigned int mapOrderTextureHeight;
+    ftss::PackFontData(mapOrderFontData, mapOrderTextureWidth, mapOrderTextureHeight, horizontalSpacing, verticalSpacing);
+
+    ftss::LocalityEstimate mapOrderEstimate;
+    ftss::EstimateTextureLocality(mapOrderEstimate, corpusStatistics, mapOrderFontData, mapOrderTextureWidth, mapOrderTextureHeight);
+    ftss::LocalityEstimate corpusOrderEstimate;
+    ftss::EstimateTextureLocality(corpusOrderEstimate, corpusStatistics, fontData, textureWidth, textureHeight);
+
+    auto missRate = [](const ftss::LocalityEstimate& localityEstimate)
+    {
+        return localityEstimate.tileAccessCount == 0 ? 0.0 :
+            100.0 * static_cast<double>(localityEstimate.tileMissCount) / static_cast<double>(localityEstimate.tileAccessCount);
+    };
+
+    std::cout << "Corpus layout at " << fontSize << " px (" << corpusOrderEstimate.glyphCount << " glyphs drawn, "
+        << ftss::LocalityEstimate::CACHE_TILE_COUNT << " cached tiles of " << ftss::LocalityEstimate::TILE_SIZE_PX << "x"
+        << ftss::LocalityEstimate::TILE_SIZE_PX << " px):" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "    Tile misses: " << corpusOrderEstimate.tileMissCount << " (" << missRate(corpusOrderEstimate) << "%), "
+        << mapOrderEstimate.tileMissCount << " (" << missRate(mapOrderEstimate) << "%) without the corpus" << std::endl;
+    std::cout << "    Hot region:  " << ftss::LocalityEstimate::HOT_SHARE * 100.0 << "% of the glyphs drawn are in the first "
+        << corpusOrderEstimate.hotWidth_px << " of " << corpusOrderEstimate.textureWidth << " px, "
+        << mapOrderEstimate.hotWidth_px << " px without the corpus" << std::endl;
+    std::cout << std::defaultfloat;
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // A straight piece of a glyph outline in font units, y pointing up
+    struct OutlineEdge
+    {
+        float x0;
+        float y0;
+        float x1;
+        float y1;
+    };
+
+    // A glyph outline with its curves flattened into edges, in font units so
+    // it can be rasterized at any size without going back to the font
+    struct GlyphOutline
+    {
+        GlyphOutline();
+
+        unsigned int sourceIndex;
+        std::vector<OutlineEdge> edges;
+
+        float xMin;
+        float yMin;
+        float xMax;
+        float yMax;
+
+        float horiAdvance;
+        float vertBearingX;
+        float vertBearingY;
+        float vertAdvance;
+    };
+
+    inline GlyphOutline::GlyphOutline()
+        : sourceIndex(0)
+        , xMin(0.0f)
+        , yMin(0.0f)
+        , xMax(0.0f)
+        , yMax(0.0f)
+        , horiAdvance(0.0f)
+        , vertBearingX(0.0f)
+        , vertBearingY(0.0f)
+        , vertAdvance(0.0f)
+    {}
+
+    // Face wide values of a font source in font units
+    struct OutlineSource
+    {
+        OutlineSource();
+
+        float unitsPerEm;
+        float lineSpacing;
+        bool used;
+    };
+
+    inline OutlineSource::OutlineSource()
+        : unitsPerEm(0.0f)
+        , lineSpacing(0.0f)
+        , used(false)
+    {}
+
+    // Every glyph outline of a character list extracted once, see LoadOutlineCache
+    struct OutlineCache
+    {
+        void Clear();
+
+        std::vector<OutlineSource> outlineSources;
+        std::unordered_map<unsigned char, GlyphOutline> glyphOutlineMap;
+    };
+
+    inline void OutlineCache::Clear()
+    {
+        outlineSources.clear();
+        glyphOutlineMap.clear();
+    }
+}
@@ -0,0 +1,262 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#include "Pipeline.h"
+
+#include "BoundedQueue.h"
+#include "FontToSpriteSheet.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+
+
+namespace ftss
+{
+    // Everything a job carries from one stage to the next, each stage
+    // releases what the stages after it don't need
+    struct PipelineItem
+    {
+        PipelineItem();
+
+        size_t jobIndex;
+        std::vector<unsigned char> characterList;
+        std::vector<unsigned char> fontFileData;
+        TextureData textureData;
+        TextureData bundleTextureData; // only for a bundle, outside the pool
+        FontData fontData;
+        std::vector<unsigned char> textureBuffer;
+        std::vector<unsigned char> fontDataBuffer;
+    };
+
+    PipelineItem::PipelineItem()
+        : jobIndex(0)
+    {}
+
+    // Pops from input until it is closed and drained, pushes what work
+    // succeeds on to output and closes output at the end. output is nullptr
+    // for the last stage.
+    template<typename Work>
+    static void RunPipelineStage_H(
+        PipelineStageReport& stageReport,
+        std::atomic<unsigned int>& failedJobCount,
+        BoundedQueue<PipelineItem>& input,
+        BoundedQueue<PipelineItem>* output,
+        Work work)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        PipelineItem item;
+        while (true)
+        {
+            Clock::time_point popStart = Clock::now();
+            bool popped = input.Pop(item);
+            Clock::time_point workStart = Clock::now();
+            stageReport.starvedTime_ms += std::chrono::duration<double, std::milli>(workStart - popStart).count();
+            if (!popped)
+            {
+                break;
+            }
+
+            bool succeeded = work(item);
+            Clock::time_point workEnd = Clock::now();
+            stageReport.busyTime_ms += std::chrono::duration<double, std::milli>(workEnd - workStart).count();
+            ++stageReport.jobCount;
+
+            if (!succeeded)
+            {
+                ++failedJobCount;
+            }
+            else if (output != nullptr)
+            {
+                output->Push(std::move(item));
+                stageReport.blockedTime_ms += std::chrono::duration<double, std::milli>(Clock::now() - workEnd).count();
+            }
+            item = PipelineItem();
+        }
+
+        if (output != nullptr)
+        {
+            output->Close();
+        }
+    }
+
+    // public ------------------------------------------------------------------
+
+    bool RunPipeline(
+        PipelineReport& pipelineReport,
+        const std::vector<PipelineJob>& jobs,
+        bool compact,
+        std::vector<FontBundleSource>* fontBundleSources,
+        size_t queueCapacity)
+    {
+        pipelineReport = PipelineReport();
+        pipelineReport.stageReports.resize(4);
+        pipelineReport.stageReports[0].name = "load";
+        pipelineReport.stageReports[1].name = "rasterize";
+        pipelineReport.stageReports[2].name = "encode";
+        pipelineReport.stageReports[3].name = "write";
+
+        // textures only live from rasterizing to encoding, so the pool only
+        // ever holds about as many as fit into the queues
+        PooledTextureAllocator textureAllocator(GetDefaultTextureAllocator(), queueCapacity + 2);
+
+        BoundedQueue<PipelineItem> loadQueue(queueCapacity);
+        BoundedQueue<PipelineItem> rasterizeQueue(queueCapacity);
+        BoundedQueue<PipelineItem> encodeQueue(queueCapacity);
+        BoundedQueue<PipelineItem> writeQueue(queueCapacity);
+        std::atomic<unsigned int> failedJobCount(0);
+        std::atomic<unsigned int> builtJobCount(0);
+
+        auto load = [&](PipelineItem& item)
+        {
+            const PipelineJob& job = jobs[item.jobIndex];
+            if (!LoadCharacterListFromFile(item.characterList, job.characterListFile))
+            {
+                std::cerr << "ERROR: loading character list failed: " << job.characterListFile << std::endl;
+                return false;
+            }
+            if (!ReadFile_H(item.fontFileData, job.fontSource.filePath))
+            {
+                std::cerr << "ERROR: loading font failed: " << job.fontSource.filePath << std::endl;
+                return false;
+            }
+            return true;
+        };
+
+        auto rasterize = [&](PipelineItem& item)
+        {
+            const PipelineJob& job = jobs[item.jobIndex];
+            item.textureData = TextureData(textureAllocator);
+            bool result = LoadTextureDataAndFontDataFromMemory(
+                item.textureData,
+                item.fontData,
+                item.characterList,
+                item.fontFileData.data(),
+                item.fontFileData.size(),
+                job.fontHeightInPixels,
+                job.horizontalSpacing,
+                job.verticalSpacing,
+                job.fontSource.faceIndex);
+            std::vector<unsigned char>().swap(item.fontFileData);
+            if (!result)
+            {
+                std::cerr << "ERROR: loading texture data and font data failed: " << job.textureFile << std::endl;
+            }
+            return result;
+        };
+
+        auto encode = [&](PipelineItem& item)
+        {
+            const PipelineJob& job = jobs[item.jobIndex];
+            if (!EncodeTextureData(item.textureBuffer, item.textureData))
+            {
+                std::cerr << "ERROR: encoding texture data failed: " << job.textureFile << std::endl;
+                return false;
+            }
+
+            // the pooled texture goes back for the next job, the bundle keeps a copy
+            if (fontBundleSources != nullptr)
+            {
+                const TextureData& textureData = item.textureData;
+                if (!item.bundleTextureData.Allocate(textureData.width, textureData.height, textureData.bytesPerPixel))
+                {
+                    std::cerr << "ERROR: allocating the bundle texture failed: " << job.textureFile << std::endl;
+                    return false;
+                }
+                std::memcpy(item.bundleTextureData.data, textureData.data, textureData.GetSize());
+            }
+            item.textureData.Clear();
+
+            // checked here against what was encoded, the write is atomic so
+            // the file ends up with exactly these bytes
+            if (compact)
+            {
+                CompactFontData compactFontData;
+                CompactFontData compactFontData_copy;
+                if (!ConvertToCompactFontData(compactFontData, item.fontData))
+                {
+                    std::cerr << "ERROR: converting to compact font data failed: " << job.fontDataFile << std::endl;
+                    return false;
+                }
+                EncodeCompactFontData(item.fontDataBuffer, compactFontData);
+                if (!DecodeCompactFontData(compactFontData_copy, item.fontDataBuffer.data(), item.fontDataBuffer.size()) ||
+                    compactFontData != compactFontData_copy)
+                {
+                    std::cerr << "ERROR: font data check failed: " << job.fontDataFile << std::endl;
+                    return false;
+                }
+            }
+            else
+            {
+                FontData fontData_copy;
+                EncodeFontData(item.fontDataBuffer, item.fontData);
+                if (!DecodeFontData(fontData_copy, item.fontDataBuffer.data(), item.fontDataBuffer.size()) ||
+                    item.fontData != fontData_copy)
+                {
+                    std::cerr << "ERROR: font data check failed: " << job.fontDataFile << std::endl;
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        auto write = [&](PipelineItem& item)
+        {
+            const PipelineJob& job = jobs[item.jobIndex];
+            if (!WriteFile_H(item.textureBuffer.data(), item.textureBuffer.size(), job.textureFile) ||
+                !WriteFile_H(item.fontDataBuffer.data(), item.fontDataBuffer.size(), job.fontDataFile))
+            {
+                std::cerr << "ERROR: writing failed: " << job.textureFile << std::endl;
+                return false;
+            }
+            std::cout << "Built " << job.textureFile << " and " << job.fontDataFile << std::endl;
+            ++builtJobCount;
+
+            // only this stage touches the bundle sources, and the caller
+            // only reads them once every stage has been joined
+            if (fontBundleSources != nullptr)
+            {
+                fontBundleSources->emplace_back();
+                FontBundleSource& fontBundleSource = fontBundleSources->back();
+                fontBundleSource.fontName = job.fontName;
+                fontBundleSource.fontSize_px = job.fontHeightInPixels;
+                fontBundleSource.fontData = std::move(item.fontData);
+                fontBundleSource.textureData = std::move(item.bundleTextureData);
+            }
+            return true;
+        };
+
+        std::vector<PipelineStageReport>& stageReports = pipelineReport.stageReports;
+        auto start = std::chrono::steady_clock::now();
+
+        std::thread loadThread([&]() { RunPipelineStage_H(stageReports[0], failedJobCount, loadQueue, &rasterizeQueue, load); });
+        std::thread rasterizeThread([&]() { RunPipelineStage_H(stageReports[1], failedJobCount, rasterizeQueue, &encodeQueue, rasterize); });
+        std::thread encodeThread([&]() { RunPipelineStage_H(stageReports[2], failedJobCount, encodeQueue, &writeQueue, encode); });
+        std::thread writeThread([&]() { RunPipelineStage_H(stageReports[3], failedJobCount, writeQueue, nullptr, write); });
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            PipelineItem item;
+            item.jobIndex = i;
+            loadQueue.Push(std::move(item));
+        }
+        loadQueue.Close();
+
+        loadThread.join();
+        rasterizeThread.join();
+        encodeThread.join();
+        writeThread.join();
+
+        auto end = std::chrono::steady_clock::now();
+        pipelineReport.wallTime_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        pipelineReport.builtJobCount = builtJobCount;
+        pipelineReport.failedJobCount = failedJobCount;
+
+        return failedJobCount == 0;
+    }
+}
@@ -0,0 +1,89 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include "FontBundle.h"
+#include "FontSource.h"
+
+#include <string>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // One sprite sheet to build, the same parameters the program takes
+    struct PipelineJob
+    {
+        PipelineJob();
+
+        unsigned int fontHeightInPixels;
+        unsigned int horizontalSpacing;
+        unsigned int verticalSpacing;
+        FontSource fontSource;
+        std::string characterListFile;
+        std::string textureFile;
+        std::string fontDataFile;
+        std::string fontName; // the key of the font in a bundle
+    };
+
+    inline PipelineJob::PipelineJob()
+        : fontHeightInPixels(48)
+        , horizontalSpacing(1)
+        , verticalSpacing(1)
+    {}
+
+    // Where the time of one stage went while the pipeline ran
+    struct PipelineStageReport
+    {
+        PipelineStageReport();
+
+        std::string name;
+        unsigned int jobCount;
+        double busyTime_ms;    // working on jobs
+        double starvedTime_ms; // waiting for the stage before it
+        double blockedTime_ms; // waiting for room in the queue after it
+    };
+
+    inline PipelineStageReport::PipelineStageReport()
+        : jobCount(0)
+        , busyTime_ms(0.0)
+        , starvedTime_ms(0.0)
+        , blockedTime_ms(0.0)
+    {}
+
+    struct PipelineReport
+    {
+        PipelineReport();
+
+        double wallTime_ms;
+        unsigned int builtJobCount;
+        unsigned int failedJobCount;
+        std::vector<PipelineStageReport> stageReports;
+    };
+
+    inline PipelineReport::PipelineReport()
+        : wallTime_ms(0.0)
+        , builtJobCount(0)
+        , failedJobCount(0)
+    {}
+
+    // Builds every job in four stages that run on their own threads: load
+    // the character list and font file, rasterize and pack, encode the PNG
+    // and font data, write the files. So one job can be rasterized while
+    // the one before it is encoded and the one before that is written. At
+    // most queueCapacity jobs wait between two stages, a full queue stalls
+    // the stage before it and so caps the memory in flight. A failed job
+    // is dropped and the rest still get built, false if any job failed.
+    // With fontBundleSources the write stage also appends the font data and
+    // a copy of the texture of every built job to it, in job order, so all
+    // of the textures stay in memory until the bundle is written.
+    bool RunPipeline(
+        PipelineReport& pipelineReport,
+        const std::vector<PipelineJob>& jobs,
+        bool compact = false,
+        std::vector<FontBundleSource>* fontBundleSources = nullptr,
+        size_t queueCapacity = 2);
+}
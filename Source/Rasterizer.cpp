@@ -0,0 +1,244 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#include "Rasterizer.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+
+namespace ftss
+{
+#if defined(FTSS_X86)
+    static const bool s_hasAvx2 = HasAvx2_H();
+
+    FTSS_TARGET_AVX2 static unsigned int AccumulateCoverageAvx2_H(
+        const float* accumulation,
+        unsigned char* coverage,
+        unsigned int count,
+        float& sum)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 maxValue = _mm256_set1_ps(255.0f);
+        const __m256i lastElement = _mm256_set1_epi32(7);
+
+        __m256 offset = _mm256_setzero_ps();
+        unsigned int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            // prefix sum inside each 128 bit lane, then carry the low lane into the high one
+            __m256 x = _mm256_loadu_ps(accumulation + i);
+            x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+            x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+            __m256 lowLaneSum = _mm256_permute2f128_ps(x, x, 0x08);
+            x = _mm256_add_ps(x, _mm256_shuffle_ps(lowLaneSum, lowLaneSum, 0xFF));
+            x = _mm256_add_ps(x, offset);
+            offset = _mm256_permutevar8x32_ps(x, lastElement);
+
+            __m256 y = _mm256_min_ps(_mm256_andnot_ps(signMask, x), one);
+            __m256i values = _mm256_cvtps_epi32(_mm256_mul_ps(y, maxValue));
+            __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+            __m128i bytes = _mm_packus_epi16(words, words);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(coverage + i), bytes);
+        }
+        sum = _mm_cvtss_f32(_mm256_castps256_ps128(offset));
+        return i;
+    }
+
+    static unsigned int AccumulateCoverageSse2_H(
+        const float* accumulation,
+        unsigned char* coverage,
+        unsigned int count,
+        float& sum)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 maxValue = _mm_set1_ps(255.0f);
+
+        __m128 offset = _mm_setzero_ps();
+        unsigned int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(accumulation + i);
+            x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+            x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+            x = _mm_add_ps(x, offset);
+            offset = _mm_shuffle_ps(x, x, 0xFF);
+
+            __m128 y = _mm_min_ps(_mm_andnot_ps(signMask, x), one);
+            __m128i values = _mm_cvtps_epi32(_mm_mul_ps(y, maxValue));
+            __m128i words = _mm_packs_epi32(values, values);
+            __m128i bytes = _mm_packus_epi16(words, words);
+            int packed = _mm_cvtsi128_si32(bytes);
+            std::memcpy(coverage + i, &packed, 4);
+        }
+        sum = _mm_cvtss_f32(offset);
+        return i;
+    }
+#endif
+
+    // public ------------------------------------------------------------------
+
+    void RasterizeGlyphOutline(
+        std::vector<unsigned char>& coverage,
+        std::vector<float>& accumulation,
+        const GlyphOutline& glyphOutline,
+        float scale,
+        float originX,
+        float originY,
+        unsigned int width,
+        unsigned int height)
+    {
+        coverage.assign(static_cast<size_t>(width) * height, 0);
+        if (width == 0 || height == 0)
+        {
+            return;
+        }
+
+        // two columns of padding take what edges leave right of the last pixel
+        unsigned int stride = width + 2;
+        accumulation.assign(static_cast<size_t>(stride) * height, 0.0f);
+
+        for (const OutlineEdge& edge : glyphOutline.edges)
+        {
+            AccumulateEdge_H(
+                accumulation.data(),
+                stride,
+                width,
+                height,
+                originX + edge.x0 * scale,
+                originY - edge.y0 * scale,
+                originX + edge.x1 * scale,
+                originY - edge.y1 * scale);
+        }
+
+        for (unsigned int j = 0; j < height; ++j)
+        {
+            AccumulateCoverage_H(
+                accumulation.data() + static_cast<size_t>(j) * stride,
+                coverage.data() + static_cast<size_t>(j) * width,
+                width);
+        }
+    }
+
+    // protected ---------------------------------------------------------------
+
+    void AccumulateEdge_H(
+        float* accumulation,
+        unsigned int stride,
+        unsigned int width,
+        unsigned int height,
+        float x0,
+        float y0,
+        float x1,
+        float y1)
+    {
+        if (y0 == y1)
+        {
+            return;
+        }
+
+        // walk from top to bottom, the direction decides the sign of the area
+        float direction = 1.0f;
+        if (y0 > y1)
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+            direction = -1.0f;
+        }
+
+        const float maxX = static_cast<float>(width);
+        x0 = std::min(std::max(x0, 0.0f), maxX);
+        x1 = std::min(std::max(x1, 0.0f), maxX);
+
+        float dxdy = (x1 - x0) / (y1 - y0);
+        float x = x0;
+        if (y0 < 0.0f)
+        {
+            x -= y0 * dxdy;
+        }
+
+        int rowStart = std::max(static_cast<int>(std::floor(y0)), 0);
+        int rowEnd = std::min(static_cast<int>(std::ceil(y1)), static_cast<int>(height));
+        for (int row = rowStart; row < rowEnd; ++row)
+        {
+            float* line = accumulation + static_cast<size_t>(row) * stride;
+            float dy = std::min(static_cast<float>(row + 1), y1) - std::max(static_cast<float>(row), y0);
+            float xNext = x + dxdy * dy;
+            float d = dy * direction;
+
+            float left = std::min(x, xNext);
+            float right = std::max(x, xNext);
+            float leftFloor = std::floor(left);
+            int leftIndex = static_cast<int>(leftFloor);
+            float rightCeil = std::ceil(right);
+            int rightIndex = static_cast<int>(rightCeil);
+
+            if (rightIndex <= leftIndex + 1)
+            {
+                // the edge stays inside one pixel on this row
+                float middle = 0.5f * (x + xNext) - leftFloor;
+                line[leftIndex] += d - d * middle;
+                line[leftIndex + 1] += d * middle;
+            }
+            else
+            {
+                float inverseWidth = 1.0f / (right - left);
+                float leftFraction = left - leftFloor;
+                float leftArea = 0.5f * inverseWidth * (1.0f - leftFraction) * (1.0f - leftFraction);
+                float rightFraction = right - rightCeil + 1.0f;
+                float rightArea = 0.5f * inverseWidth * rightFraction * rightFraction;
+
+                line[leftIndex] += d * leftArea;
+                if (rightIndex == leftIndex + 2)
+                {
+                    line[leftIndex + 1] += d * (1.0f - leftArea - rightArea);
+                }
+                else
+                {
+                    float area = inverseWidth * (1.5f - leftFraction);
+                    line[leftIndex + 1] += d * (area - leftArea);
+                    for (int column = leftIndex + 2; column < rightIndex - 1; ++column)
+                    {
+                        line[column] += d * inverseWidth;
+                    }
+                    float lastArea = area + static_cast<float>(rightIndex - leftIndex - 3) * inverseWidth;
+                    line[rightIndex - 1] += d * (1.0f - lastArea - rightArea);
+                }
+                line[rightIndex] += d * rightArea;
+            }
+
+            x = xNext;
+        }
+    }
+
+    void AccumulateCoverage_H(
+        const float* accumulation,
+        unsigned char* coverage,
+        unsigned int count)
+    {
+        float sum = 0.0f;
+        unsigned int i = 0;
+#if defined(FTSS_X86)
+        if (s_hasAvx2)
+        {
+            i = AccumulateCoverageAvx2_H(accumulation, coverage, count, sum);
+        }
+        else
+        {
+            i = AccumulateCoverageSse2_H(accumulation, coverage, count, sum);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            sum += accumulation[i];
+            float value = std::min(std::fabs(sum), 1.0f) * 255.0f;
+            coverage[i] = static_cast<unsigned char>(std::lrint(value));
+        }
+    }
+}
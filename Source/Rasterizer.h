@@ -0,0 +1,70 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include "OutlineCache.h"
+
+#include <vector>
+
+
+
+namespace ftss
+{
+    // Result of CompareWithReferenceRasterizer, differences are in coverage
+    // levels from 0 to 255
+    struct RasterizerComparison
+    {
+        RasterizerComparison();
+
+        unsigned int glyphCount;
+        unsigned int maxDifference;
+        unsigned char maxDifferenceCharacter;
+        double meanDifference;
+        double nativeTime_ms;
+        double referenceTime_ms;
+    };
+
+    inline RasterizerComparison::RasterizerComparison()
+        : glyphCount(0)
+        , maxDifference(0)
+        , maxDifferenceCharacter(0)
+        , meanDifference(0.0)
+        , nativeTime_ms(0.0)
+        , referenceTime_ms(0.0)
+    {}
+
+    // Rasterizes the outline scaled by scale into a width * height coverage
+    // bitmap, row 0 at the top. (originX, originY) is the pixel position of
+    // the outline origin measured from the top left corner. Every edge adds
+    // its signed area to an accumulation buffer, a prefix sum over each row
+    // then turns that into coverage. The prefix sum uses AVX2 or SSE2 when
+    // the processor has them.
+    void RasterizeGlyphOutline(
+        std::vector<unsigned char>& coverage,
+        std::vector<float>& accumulation,
+        const GlyphOutline& glyphOutline,
+        float scale,
+        float originX,
+        float originY,
+        unsigned int width,
+        unsigned int height);
+
+    // Used in RasterizeGlyphOutline, adds an edge given in pixels
+    void AccumulateEdge_H(
+        float* accumulation,
+        unsigned int stride,
+        unsigned int width,
+        unsigned int height,
+        float x0,
+        float y0,
+        float x1,
+        float y1);
+
+    // Used in RasterizeGlyphOutline, prefix sum of one row into coverage
+    void AccumulateCoverage_H(
+        const float* accumulation,
+        unsigned char* coverage,
+        unsigned int count);
+}
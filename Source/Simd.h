@@ -0,0 +1,42 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FTSS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// the AVX2 paths are compiled for AVX2 on their own and only taken when the
+// processor has it, the rest of the program keeps the default target
+#if defined(FTSS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FTSS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FTSS_TARGET_AVX2
+#endif
+
+
+
+namespace ftss
+{
+#if defined(FTSS_X86)
+    // SSE2 is part of x86-64 and taken for granted, AVX2 has to be asked for
+    inline bool HasAvx2_H()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+}
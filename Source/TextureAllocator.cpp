@@ -0,0 +1,191 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#include "TextureAllocator.h"
+
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+
+
+namespace ftss
+{
+    // public ------------------------------------------------------------------
+
+    void* AlignedTextureAllocator::Allocate(size_t size)
+    {
+#if defined(_WIN32)
+        return _aligned_malloc(size, TEXTURE_DATA_ALIGNMENT);
+#else
+        void* data = nullptr;
+        if (posix_memalign(&data, TEXTURE_DATA_ALIGNMENT, size) != 0)
+        {
+            return nullptr;
+        }
+        return data;
+#endif
+    }
+
+    void AlignedTextureAllocator::Deallocate(void* data, size_t size)
+    {
+        (void)size;
+#if defined(_WIN32)
+        _aligned_free(data);
+#else
+        free(data);
+#endif
+    }
+
+    void* HugePageTextureAllocator::Allocate(size_t size)
+    {
+#if defined(_WIN32)
+        // large pages need the SeLockMemoryPrivilege, without it use regular pages
+        SIZE_T largePageSize = GetLargePageMinimum();
+        if (largePageSize != 0)
+        {
+            SIZE_T roundedSize = (size + largePageSize - 1) / largePageSize * largePageSize;
+            void* data = VirtualAlloc(nullptr, roundedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (data != nullptr)
+            {
+                return data;
+            }
+        }
+        return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+        const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+        size_t roundedSize = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void* data = mmap(nullptr, roundedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data == MAP_FAILED)
+        {
+            // no reserved huge pages, ask for transparent ones instead
+            data = mmap(nullptr, roundedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (data == MAP_FAILED)
+            {
+                return nullptr;
+            }
+            madvise(data, roundedSize, MADV_HUGEPAGE);
+        }
+        return data;
+#else
+        return AlignedTextureAllocator().Allocate(size);
+#endif
+    }
+
+    void HugePageTextureAllocator::Deallocate(void* data, size_t size)
+    {
+        if (data == nullptr)
+        {
+            return;
+        }
+#if defined(_WIN32)
+        (void)size;
+        VirtualFree(data, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+        size_t roundedSize = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        munmap(data, roundedSize);
+#else
+        AlignedTextureAllocator().Deallocate(data, size);
+#endif
+    }
+
+    PooledTextureAllocator::PooledTextureAllocator(TextureAllocator& upstream, size_t maxPooledBlocks)
+        : m_upstream(upstream)
+        , m_maxPooledBlocks(maxPooledBlocks)
+    {}
+
+    PooledTextureAllocator::~PooledTextureAllocator()
+    {
+        Trim();
+    }
+
+    void* PooledTextureAllocator::Allocate(size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // smallest pooled block that fits
+        size_t bestIndex = m_freeBlocks.size();
+        for (size_t i = 0; i < m_freeBlocks.size(); ++i)
+        {
+            if (m_freeBlocks[i].size >= size &&
+                (bestIndex == m_freeBlocks.size() || m_freeBlocks[i].size < m_freeBlocks[bestIndex].size))
+            {
+                bestIndex = i;
+            }
+        }
+
+        Block block;
+        if (bestIndex != m_freeBlocks.size())
+        {
+            block = m_freeBlocks[bestIndex];
+            m_freeBlocks.erase(m_freeBlocks.begin() + bestIndex);
+        }
+        else
+        {
+            block.data = m_upstream.Allocate(size);
+            block.size = size;
+            if (block.data == nullptr)
+            {
+                return nullptr;
+            }
+        }
+
+        m_usedBlocks.push_back(block);
+        return block.data;
+    }
+
+    void PooledTextureAllocator::Deallocate(void* data, size_t size)
+    {
+        if (data == nullptr)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // the caller only knows the size it asked for, the block may be bigger
+        Block block = { data, size };
+        for (size_t i = 0; i < m_usedBlocks.size(); ++i)
+        {
+            if (m_usedBlocks[i].data == data)
+            {
+                block = m_usedBlocks[i];
+                m_usedBlocks.erase(m_usedBlocks.begin() + i);
+                break;
+            }
+        }
+
+        if (m_freeBlocks.size() < m_maxPooledBlocks)
+        {
+            m_freeBlocks.push_back(block);
+        }
+        else
+        {
+            m_upstream.Deallocate(block.data, block.size);
+        }
+    }
+
+    void PooledTextureAllocator::Trim()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const Block& block : m_freeBlocks)
+        {
+            m_upstream.Deallocate(block.data, block.size);
+        }
+        m_freeBlocks.clear();
+    }
+
+    TextureAllocator& GetDefaultTextureAllocator()
+    {
+        static AlignedTextureAllocator s_defaultTextureAllocator;
+        return s_defaultTextureAllocator;
+    }
+}
@@ -0,0 +1,77 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+
+
+namespace ftss
+{
+    // Texture memory is aligned to this by every allocator, wide enough for
+    // any SIMD register and a cache line
+    static const size_t TEXTURE_DATA_ALIGNMENT = 64;
+
+    // Supplies the memory of TextureData. Deallocate always gets the same
+    // size that was passed to Allocate.
+    struct TextureAllocator
+    {
+        virtual ~TextureAllocator() {}
+
+        virtual void* Allocate(size_t size) = 0;
+        virtual void Deallocate(void* data, size_t size) = 0;
+    };
+
+    // Heap memory aligned to TEXTURE_DATA_ALIGNMENT, used by default
+    struct AlignedTextureAllocator : public TextureAllocator
+    {
+        void* Allocate(size_t size) override;
+        void Deallocate(void* data, size_t size) override;
+    };
+
+    // Memory backed by huge pages where the system has them available,
+    // which saves TLB misses on large textures. Falls back to transparent
+    // huge pages or regular pages when they aren't.
+    struct HugePageTextureAllocator : public TextureAllocator
+    {
+        void* Allocate(size_t size) override;
+        void Deallocate(void* data, size_t size) override;
+    };
+
+    // Keeps deallocated blocks and hands them out again for requests that
+    // fit, so batch jobs recycle their textures instead of going back to
+    // the upstream allocator. Thread safe.
+    struct PooledTextureAllocator : public TextureAllocator
+    {
+        PooledTextureAllocator(TextureAllocator& upstream, size_t maxPooledBlocks = 8);
+        ~PooledTextureAllocator() override;
+
+        PooledTextureAllocator(const PooledTextureAllocator&) = delete;
+        PooledTextureAllocator& operator=(const PooledTextureAllocator&) = delete;
+
+        void* Allocate(size_t size) override;
+        void Deallocate(void* data, size_t size) override;
+
+        // Returns every pooled block to the upstream allocator
+        void Trim();
+
+    private:
+        struct Block
+        {
+            void* data;
+            size_t size;
+        };
+
+        TextureAllocator& m_upstream;
+        size_t m_maxPooledBlocks;
+        std::vector<Block> m_freeBlocks;
+        std::vector<Block> m_usedBlocks;
+        std::mutex m_mutex;
+    };
+
+    TextureAllocator& GetDefaultTextureAllocator();
+}
@@ -4,24 +4,45 @@
 
 #pragma once
 
-#include <cstdlib>
+#include "TextureAllocator.h"
+
+#include <cstddef>
 
 
 
 namespace ftss
 {
+    // Move only. The memory either comes from a TextureAllocator, and is
+    // reused by Allocate as long as it is big enough, or is a buffer the
+    // caller owns, which is never freed.
     struct TextureData
     {
         TextureData();
+        explicit TextureData(TextureAllocator& allocator);
+        TextureData(unsigned char* buffer, size_t bufferSize);
+
+        TextureData(const TextureData&) = delete;
+        TextureData& operator=(const TextureData&) = delete;
+
+        TextureData(TextureData&& other) noexcept;
+        TextureData& operator=(TextureData&& other) noexcept;
 
         ~TextureData();
 
+        // Sets the size and makes sure data can hold it, the contents are undefined
+        bool Allocate(unsigned int width, unsigned int height, unsigned int bytesPerPixel);
+
         void Clear();
+
+        size_t GetSize() const;
         
         unsigned char* data;
         unsigned int width;
         unsigned int height;
         unsigned int bytesPerPixel;
+
+        size_t capacity;
+        TextureAllocator* allocator; // nullptr when data is owned by the caller
     };
 
     inline TextureData::TextureData()
@@ -29,20 +50,117 @@ namespace ftss
         , width(0)
         , height(0)
         , bytesPerPixel(0)
+        , capacity(0)
+        , allocator(&GetDefaultTextureAllocator())
+    {}
+
+    inline TextureData::TextureData(TextureAllocator& allocator)
+        : data(nullptr)
+        , width(0)
+        , height(0)
+        , bytesPerPixel(0)
+        , capacity(0)
+        , allocator(&allocator)
+    {}
+
+    inline TextureData::TextureData(unsigned char* buffer, size_t bufferSize)
+        : data(buffer)
+        , width(0)
+        , height(0)
+        , bytesPerPixel(0)
+        , capacity(bufferSize)
+        , allocator(nullptr)
     {}
 
+    inline TextureData::TextureData(TextureData&& other) noexcept
+        : data(other.data)
+        , width(other.width)
+        , height(other.height)
+        , bytesPerPixel(other.bytesPerPixel)
+        , capacity(other.capacity)
+        , allocator(other.allocator)
+    {
+        other.data = nullptr;
+        other.width = 0;
+        other.height = 0;
+        other.bytesPerPixel = 0;
+        other.capacity = 0;
+    }
+
+    inline TextureData& TextureData::operator=(TextureData&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (allocator != nullptr)
+            {
+                allocator->Deallocate(data, capacity);
+            }
+
+            data = other.data;
+            width = other.width;
+            height = other.height;
+            bytesPerPixel = other.bytesPerPixel;
+            capacity = other.capacity;
+            allocator = other.allocator;
+
+            other.data = nullptr;
+            other.width = 0;
+            other.height = 0;
+            other.bytesPerPixel = 0;
+            other.capacity = 0;
+        }
+        return *this;
+    }
+
     inline TextureData::~TextureData()
     {
-        free(data);
+        if (allocator != nullptr)
+        {
+            allocator->Deallocate(data, capacity);
+        }
         data = nullptr;
     }
 
+    inline bool TextureData::Allocate(unsigned int width, unsigned int height, unsigned int bytesPerPixel)
+    {
+        size_t size = static_cast<size_t>(width) * height * bytesPerPixel;
+        if (data == nullptr || size > capacity)
+        {
+            if (allocator == nullptr)
+            {
+                return false;
+            }
+
+            allocator->Deallocate(data, capacity);
+            data = static_cast<unsigned char*>(allocator->Allocate(size));
+            capacity = data != nullptr ? size : 0;
+            if (data == nullptr)
+            {
+                return false;
+            }
+        }
+
+        this->width = width;
+        this->height = height;
+        this->bytesPerPixel = bytesPerPixel;
+        return true;
+    }
+
     inline void TextureData::Clear()
     {
-        free(data);
-        data = nullptr;
+        if (allocator != nullptr)
+        {
+            allocator->Deallocate(data, capacity);
+            data = nullptr;
+            capacity = 0;
+        }
         width = 0;
         height = 0;
         bytesPerPixel = 0;
     }
-}
\ No newline at end of file
+
+    inline size_t TextureData::GetSize() const
+    {
+        return static_cast<size_t>(width) * height * bytesPerPixel;
+    }
+}
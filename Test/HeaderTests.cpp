@@ -0,0 +1,117 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+// EmbeddedFont.h is written by the build, see CMakeLists.txt. The same run
+// writes EmbeddedFont.png and EmbeddedFont.ssf next to it.
+#include "EmbeddedFont.h"
+
+#include "FontToSpriteSheet.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+
+// the lookup has to work at compile time, not only at run time
+static_assert(EmbeddedFont::FindGlyphMetrics('A')->character == 'A', "the lookup finds the glyph it was asked for");
+static_assert(EmbeddedFont::FindGlyphMetrics('~')->character == '~', "the lookup finds the last glyph");
+static_assert(EmbeddedFont::FindGlyphMetrics('\t') == nullptr, "tabs aren't in the character list");
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage:" << std::endl;
+        std::cerr << "    ./FontToSpriteSheetHeaderTests <embedded_font_directory>" << std::endl;
+        std::cerr << std::endl;
+        std::cerr << "    compares the compiled in EmbeddedFont.h with the font data and texture" << std::endl;
+        std::cerr << "    files written in the same run" << std::endl;
+        return 1;
+    }
+
+    const std::string outputDirectory = argv[1];
+
+    ftss::FontData fontData;
+    if (!ftss::ReadFontData(fontData, outputDirectory + "/EmbeddedFont.ssf"))
+    {
+        std::cerr << "FAILED: reading EmbeddedFont.ssf failed" << std::endl;
+        return 1;
+    }
+
+    unsigned int failureCount = 0;
+    if (EmbeddedFont::LINE_SPACING_PX != fontData.lineSpacing_px ||
+        EmbeddedFont::GLYPH_COUNT != fontData.glyphMetricsMap.size() ||
+        EmbeddedFont::SUBPIXEL_VARIANT_COUNT != fontData.subpixelVariantCount)
+    {
+        std::cerr << "FAILED: the line spacing, glyph count or subpixel variant count differs" << std::endl;
+        ++failureCount;
+    }
+
+    // every character, so the lookup also has to miss where the file has no glyph
+    for (unsigned int c = 0; c < 256; ++c)
+    {
+        auto iter = fontData.glyphMetricsMap.find(static_cast<unsigned char>(c));
+        const EmbeddedFont::GlyphMetrics* embedded = EmbeddedFont::FindGlyphMetrics(static_cast<unsigned char>(c));
+        if (iter == fontData.glyphMetricsMap.end() || embedded == nullptr)
+        {
+            if (iter != fontData.glyphMetricsMap.end() || embedded != nullptr)
+            {
+                std::cerr << "FAILED: character " << c << " is only in one of the header and the file" << std::endl;
+                ++failureCount;
+            }
+            continue;
+        }
+
+        const ftss::GlyphMetrics& metrics = iter->second;
+        if (embedded < EmbeddedFont::GLYPH_METRICS || embedded >= EmbeddedFont::GLYPH_METRICS + EmbeddedFont::GLYPH_COUNT ||
+            embedded->character != c ||
+            embedded->width_px != metrics.width_px ||
+            embedded->height_px != metrics.height_px ||
+            embedded->horiBearingX_px != metrics.horiBearingX_px ||
+            embedded->horiBearingY_px != metrics.horiBearingY_px ||
+            embedded->horiAdvance_px != metrics.horiAdvance_px ||
+            embedded->vertBearingX_px != metrics.vertBearingX_px ||
+            embedded->vertBearingY_px != metrics.vertBearingY_px ||
+            embedded->vertAdvance_px != metrics.vertAdvance_px ||
+            embedded->textureLeft != metrics.textureLeft ||
+            embedded->textureRight != metrics.textureRight ||
+            embedded->textureBottom != metrics.textureBottom ||
+            embedded->textureTop != metrics.textureTop ||
+            embedded->channel != metrics.channel)
+        {
+            std::cerr << "FAILED: the metrics of character " << c << " differ" << std::endl;
+            ++failureCount;
+        }
+    }
+
+    // PNG encoding is deterministic, the same pixels give the same file
+    std::vector<unsigned char> pngBuffer;
+    if (!ftss::ReadFile_H(pngBuffer, outputDirectory + "/EmbeddedFont.png"))
+    {
+        std::cerr << "FAILED: reading EmbeddedFont.png failed" << std::endl;
+        return 1;
+    }
+
+    std::vector<unsigned char> pixels(EmbeddedFont::TEXTURE_DATA, EmbeddedFont::TEXTURE_DATA + sizeof(EmbeddedFont::TEXTURE_DATA));
+    ftss::TextureData textureData(pixels.data(), pixels.size());
+    textureData.width = EmbeddedFont::TEXTURE_WIDTH;
+    textureData.height = EmbeddedFont::TEXTURE_HEIGHT;
+    textureData.bytesPerPixel = EmbeddedFont::TEXTURE_BYTES_PER_PIXEL;
+
+    std::vector<unsigned char> embeddedPngBuffer;
+    if (textureData.GetSize() != pixels.size() ||
+        !ftss::EncodeTextureData(embeddedPngBuffer, textureData) ||
+        embeddedPngBuffer != pngBuffer)
+    {
+        std::cerr << "FAILED: the texture differs from EmbeddedFont.png" << std::endl;
+        ++failureCount;
+    }
+
+    if (failureCount == 0)
+    {
+        std::cout << "The header matches the font data and texture of " << EmbeddedFont::GLYPH_COUNT << " glyphs" << std::endl;
+    }
+    return failureCount == 0 ? 0 : 1;
+}
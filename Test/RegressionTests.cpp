@@ -0,0 +1,719 @@
+// =============================================================================
+// @AUTHOR Vik Pandher
+// @DATE 2024-10-30
+
+#include "CorpusLayout.h"
+#include "FontBundle.h"
+#include "FontToSpriteSheet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+
+
+// One atlas build, the hashes are what Golden.txt holds for it
+struct TestCase
+{
+    TestCase();
+
+    std::string fontFile;
+    unsigned int fontHeightInPixels;
+    unsigned int horizontalSpacing;
+    unsigned int verticalSpacing;
+    unsigned long long metricsHash;
+    unsigned long long pixelHash;
+};
+
+TestCase::TestCase()
+    : fontHeightInPixels(0)
+    , horizontalSpacing(0)
+    , verticalSpacing(0)
+    , metricsHash(0)
+    , pixelHash(0)
+{}
+
+// Time spent in each stage summed over all test cases, the best of a few runs
+struct StageTimings
+{
+    StageTimings();
+
+    double render_ms;
+    double encodeTexture_ms;
+    double encodeFontData_ms;
+    double decodeFontData_ms;
+};
+
+StageTimings::StageTimings()
+    : render_ms(0.0)
+    , encodeTexture_ms(0.0)
+    , encodeFontData_ms(0.0)
+    , decodeFontData_ms(0.0)
+{}
+
+const char* const FONT_FILES[] = { "Action Man.ttf", "Antonio-Regular.ttf", "CascadiaCode.ttf" };
+const unsigned int FONT_SIZES[] = { 16, 48, 96 };
+const unsigned int SPACINGS[][2] = { { 0, 0 }, { 1, 1 }, { 4, 2 } };
+const char* const CHARACTER_LIST_FILE = "CharacterList_01.txt";
+const unsigned int TIMING_RUN_COUNT = 3;
+// a single font data encode or decode takes a few microseconds, too short to time alone
+const unsigned int FONT_DATA_TIMING_REPEAT_COUNT = 100;
+// CTest reports the test as skipped instead of failed, see SKIP_RETURN_CODE
+const int SKIPPED_RETURN_CODE = 77;
+
+int RunGoldenTest(const std::string& testDirectory, bool update);
+int RunBudgetTest(const std::string& testDirectory);
+int RunLocalityTest();
+std::vector<TestCase> GetTestCases();
+bool BuildTestCase(
+    ftss::TextureData& textureData,
+    ftss::FontData& fontData,
+    StageTimings& stageTimings,
+    const TestCase& testCase,
+    const std::vector<unsigned char>& characterList,
+    const std::string& testDirectory);
+bool CheckRoundTrip(const ftss::TextureData& textureData, const ftss::FontData& fontData);
+unsigned long long HashMetrics(const ftss::FontData& fontData);
+unsigned long long HashPixels(const ftss::TextureData& textureData, const ftss::FontData& fontData);
+void HashBytes(unsigned long long& hash, const void* data, size_t size);
+bool LoadGoldenFile(std::vector<TestCase>& testCases, const std::string& filePath);
+bool WriteGoldenFile(const std::vector<TestCase>& testCases, const std::string& filePath);
+bool LoadBudgetFile(std::vector<std::pair<std::string, double>>& budgets, double& margin, const std::string& filePath);
+size_t GetPeakMemory_kB();
+double GetElapsed_ms(std::chrono::steady_clock::time_point start);
+
+int main(int argc, char** argv)
+{
+    if (argc < 3 || argc > 4 ||
+        (std::string(argv[1]) != "golden" && std::string(argv[1]) != "budgets" && std::string(argv[1]) != "locality") ||
+        (argc == 4 && std::string(argv[3]) != "--update"))
+    {
+        std::cerr << "Usage:" << std::endl;
+        std::cerr << "    ./FontToSpriteSheetTests golden <test_directory> [--update]" << std::endl;
+        std::cerr << "    ./FontToSpriteSheetTests budgets <test_directory>" << std::endl;
+        std::cerr << "    ./FontToSpriteSheetTests locality <test_directory>" << std::endl;
+        std::cerr << std::endl;
+        std::cerr << "    golden   builds every test case and compares its metrics and pixels" << std::endl;
+        std::cerr << "             with Golden.txt, --update writes Golden.txt instead" << std::endl;
+        std::cerr << "    budgets  times the stages over all test cases and checks them and the" << std::endl;
+        std::cerr << "             peak memory against Budgets.txt, skipped without NDEBUG" << std::endl;
+        std::cerr << "    locality checks the texture cache estimate on a hand built atlas" << std::endl;
+        return 1;
+    }
+
+    std::string testDirectory = argv[2];
+    if (std::string(argv[1]) == "golden")
+    {
+        return RunGoldenTest(testDirectory, argc == 4);
+    }
+    if (std::string(argv[1]) == "locality")
+    {
+        return RunLocalityTest();
+    }
+    return RunBudgetTest(testDirectory);
+}
+
+int RunGoldenTest(const std::string& testDirectory, bool update)
+{
+    std::vector<unsigned char> characterList;
+    if (!ftss::LoadCharacterListFromFile(characterList, testDirectory + "/" + CHARACTER_LIST_FILE))
+    {
+        return 1;
+    }
+
+    std::vector<TestCase> goldenCases;
+    if (!update && !LoadGoldenFile(goldenCases, testDirectory + "/Golden.txt"))
+    {
+        return 1;
+    }
+
+    std::vector<TestCase> testCases = GetTestCases();
+    unsigned int failureCount = 0;
+    for (TestCase& testCase : testCases)
+    {
+        std::ostringstream name;
+        name << testCase.fontFile << " " << testCase.fontHeightInPixels << " px, spacing "
+            << testCase.horizontalSpacing << " " << testCase.verticalSpacing;
+
+        ftss::TextureData textureData;
+        ftss::FontData fontData;
+        StageTimings stageTimings;
+        if (!BuildTestCase(textureData, fontData, stageTimings, testCase, characterList, testDirectory))
+        {
+            std::cerr << "FAILED: " << name.str() << ", the build failed" << std::endl;
+            ++failureCount;
+            continue;
+        }
+
+        if (!CheckRoundTrip(textureData, fontData))
+        {
+            std::cerr << "FAILED: " << name.str() << ", the data doesn't read back the same" << std::endl;
+            ++failureCount;
+        }
+
+        testCase.metricsHash = HashMetrics(fontData);
+        testCase.pixelHash = HashPixels(textureData, fontData);
+        if (update)
+        {
+            continue;
+        }
+
+        auto golden = std::find_if(goldenCases.begin(), goldenCases.end(), [&](const TestCase& goldenCase)
+        {
+            return goldenCase.fontFile == testCase.fontFile &&
+                goldenCase.fontHeightInPixels == testCase.fontHeightInPixels &&
+                goldenCase.horizontalSpacing == testCase.horizontalSpacing &&
+                goldenCase.verticalSpacing == testCase.verticalSpacing;
+        });
+        if (golden == goldenCases.end())
+        {
+            std::cerr << "FAILED: " << name.str() << ", no golden hashes" << std::endl;
+            ++failureCount;
+        }
+        else if (golden->metricsHash != testCase.metricsHash || golden->pixelHash != testCase.pixelHash)
+        {
+            std::cerr << "FAILED: " << name.str() << std::hex << std::setfill('0') << std::endl;
+            std::cerr << "    metrics " << std::setw(16) << testCase.metricsHash << " expected " << std::setw(16) << golden->metricsHash << std::endl;
+            std::cerr << "    pixels  " << std::setw(16) << testCase.pixelHash << " expected " << std::setw(16) << golden->pixelHash << std::endl;
+            std::cerr << std::dec << std::setfill(' ');
+            ++failureCount;
+        }
+    }
+
+    if (update)
+    {
+        if (failureCount != 0 || !WriteGoldenFile(testCases, testDirectory + "/Golden.txt"))
+        {
+            std::cerr << "ERROR: Golden.txt wasn't updated" << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote the hashes of " << testCases.size() << " test cases to Golden.txt" << std::endl;
+        return 0;
+    }
+
+    std::cout << testCases.size() - failureCount << " of " << testCases.size() << " test cases match" << std::endl;
+    return failureCount == 0 ? 0 : 1;
+}
+
+int RunBudgetTest(const std::string& testDirectory)
+{
+#if !defined(NDEBUG)
+    // the budgets are timings of an optimized build, a debug build misses them by far
+    std::cout << "Skipped: the budgets only hold for an optimized build (NDEBUG defined)" << std::endl;
+    return SKIPPED_RETURN_CODE;
+#endif
+
+    std::vector<unsigned char> characterList;
+    if (!ftss::LoadCharacterListFromFile(characterList, testDirectory + "/" + CHARACTER_LIST_FILE))
+    {
+        return 1;
+    }
+
+    std::vector<std::pair<std::string, double>> budgets;
+    double margin = 0.0;
+    if (!LoadBudgetFile(budgets, margin, testDirectory + "/Budgets.txt"))
+    {
+        return 1;
+    }
+
+    // the fastest run is the one least disturbed by the rest of the system
+    std::vector<TestCase> testCases = GetTestCases();
+    StageTimings bestTimings;
+    for (unsigned int run = 0; run < TIMING_RUN_COUNT; ++run)
+    {
+        StageTimings runTimings;
+        for (const TestCase& testCase : testCases)
+        {
+            ftss::TextureData textureData;
+            ftss::FontData fontData;
+            if (!BuildTestCase(textureData, fontData, runTimings, testCase, characterList, testDirectory))
+            {
+                std::cerr << "FAILED: building " << testCase.fontFile << " failed" << std::endl;
+                return 1;
+            }
+        }
+
+        if (run == 0)
+        {
+            bestTimings = runTimings;
+        }
+        bestTimings.render_ms = std::min(bestTimings.render_ms, runTimings.render_ms);
+        bestTimings.encodeTexture_ms = std::min(bestTimings.encodeTexture_ms, runTimings.encodeTexture_ms);
+        bestTimings.encodeFontData_ms = std::min(bestTimings.encodeFontData_ms, runTimings.encodeFontData_ms);
+        bestTimings.decodeFontData_ms = std::min(bestTimings.decodeFontData_ms, runTimings.decodeFontData_ms);
+    }
+
+    const std::pair<std::string, double> measurements[] = {
+        { "render_ms", bestTimings.render_ms },
+        { "encode_texture_ms", bestTimings.encodeTexture_ms },
+        { "encode_font_data_ms", bestTimings.encodeFontData_ms },
+        { "decode_font_data_ms", bestTimings.decodeFontData_ms },
+        { "peak_memory_kb", static_cast<double>(GetPeakMemory_kB()) } };
+
+    unsigned int failureCount = 0;
+    for (const auto& measurement : measurements)
+    {
+        auto budget = std::find_if(budgets.begin(), budgets.end(), [&](const std::pair<std::string, double>& entry)
+        {
+            return entry.first == measurement.first;
+        });
+        if (budget == budgets.end())
+        {
+            std::cerr << "FAILED: no budget for " << measurement.first << std::endl;
+            ++failureCount;
+            continue;
+        }
+
+        double limit = budget->second * (1.0 + margin);
+        bool withinBudget = measurement.second <= limit;
+        std::cout << (withinBudget ? "    " : "FAILED: ") << std::left << std::setw(20) << measurement.first << std::right
+            << std::fixed << std::setprecision(1) << std::setw(10) << measurement.second
+            << " of " << budget->second << " (+" << margin * 100.0 << "% up to " << limit << ")" << std::endl;
+        std::cout << std::defaultfloat;
+        if (!withinBudget)
+        {
+            ++failureCount;
+        }
+    }
+
+    return failureCount == 0 ? 0 : 1;
+}
+
+int RunLocalityTest()
+{
+    // A is 70 px tall and makes the texture 3 tiles high, the short glyphs
+    // sit on its top edge like every glyph in the texture
+    ftss::FontData fontData;
+    fontData.glyphMetricsMap['A'].width_px = 8;
+    fontData.glyphMetricsMap['A'].height_px = 70;
+    fontData.glyphMetricsMap['B'].width_px = 8;
+    fontData.glyphMetricsMap['B'].height_px = 20;
+    fontData.glyphMetricsMap['.'].width_px = 4;
+    fontData.glyphMetricsMap['.'].height_px = 4;
+
+    unsigned int textureWidth = 0;
+    unsigned int textureHeight = 0;
+    ftss::PackFontData(fontData, textureWidth, textureHeight, 1, 1);
+
+    ftss::CorpusStatistics corpusStatistics;
+    const char text[] = ".B.B";
+    corpusStatistics.text.assign(text, text + 4);
+
+    // both short glyphs are in the first tile row, all within the first 32 px
+    ftss::LocalityEstimate localityEstimate;
+    ftss::EstimateTextureLocality(localityEstimate, corpusStatistics, fontData, textureWidth, textureHeight);
+    if (textureHeight != 72 || textureWidth > ftss::LocalityEstimate::TILE_SIZE_PX ||
+        localityEstimate.glyphCount != 4 ||
+        localityEstimate.tileAccessCount != 4 ||
+        localityEstimate.tileMissCount != 1)
+    {
+        std::cerr << "FAILED: " << localityEstimate.glyphCount << " glyphs, " << localityEstimate.tileAccessCount
+            << " tile accesses, " << localityEstimate.tileMissCount << " tile misses, expected 4, 4 and 1" << std::endl;
+        return 1;
+    }
+
+    std::cout << "The locality estimate matches the atlas" << std::endl;
+    return 0;
+}
+
+std::vector<TestCase> GetTestCases()
+{
+    std::vector<TestCase> testCases;
+    for (const char* fontFile : FONT_FILES)
+    {
+        for (unsigned int fontSize : FONT_SIZES)
+        {
+            for (const auto& spacing : SPACINGS)
+            {
+                TestCase testCase;
+                testCase.fontFile = fontFile;
+                testCase.fontHeightInPixels = fontSize;
+                testCase.horizontalSpacing = spacing[0];
+                testCase.verticalSpacing = spacing[1];
+                testCases.push_back(testCase);
+            }
+        }
+    }
+    return testCases;
+}
+
+bool BuildTestCase(
+    ftss::TextureData& textureData,
+    ftss::FontData& fontData,
+    StageTimings& stageTimings,
+    const TestCase& testCase,
+    const std::vector<unsigned char>& characterList,
+    const std::string& testDirectory)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!ftss::LoadTextureDataAndFontData(
+        textureData,
+        fontData,
+        characterList,
+        testDirectory + "/" + testCase.fontFile,
+        testCase.fontHeightInPixels,
+        testCase.horizontalSpacing,
+        testCase.verticalSpacing))
+    {
+        return false;
+    }
+    stageTimings.render_ms += GetElapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<unsigned char> textureBuffer;
+    if (!ftss::EncodeTextureData(textureBuffer, textureData))
+    {
+        return false;
+    }
+    stageTimings.encodeTexture_ms += GetElapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<unsigned char> fontDataBuffer;
+    for (unsigned int i = 0; i < FONT_DATA_TIMING_REPEAT_COUNT; ++i)
+    {
+        fontDataBuffer.clear();
+        ftss::EncodeFontData(fontDataBuffer, fontData);
+    }
+    stageTimings.encodeFontData_ms += GetElapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < FONT_DATA_TIMING_REPEAT_COUNT; ++i)
+    {
+        ftss::FontData decodedFontData;
+        if (!ftss::DecodeFontData(decodedFontData, fontDataBuffer.data(), fontDataBuffer.size()))
+        {
+            return false;
+        }
+    }
+    stageTimings.decodeFontData_ms += GetElapsed_ms(start);
+
+    return true;
+}
+
+bool CheckRoundTrip(const ftss::TextureData& textureData, const ftss::FontData& fontData)
+{
+    std::vector<unsigned char> buffer;
+    ftss::EncodeFontData(buffer, fontData);
+    ftss::FontData decodedFontData;
+    if (!ftss::DecodeFontData(decodedFontData, buffer.data(), buffer.size()) || decodedFontData != fontData)
+    {
+        return false;
+    }
+
+    // the compact format rounds the texture coordinates, the rest has to survive
+    ftss::CompactFontData compactFontData;
+    if (!ftss::ConvertToCompactFontData(compactFontData, fontData))
+    {
+        return false;
+    }
+    buffer.clear();
+    ftss::EncodeCompactFontData(buffer, compactFontData);
+    ftss::FontData compactDecodedFontData;
+    if (!ftss::DecodeFontData(compactDecodedFontData, buffer.data(), buffer.size()) ||
+        compactDecodedFontData.lineSpacing_px != fontData.lineSpacing_px ||
+        compactDecodedFontData.glyphMetricsMap.size() != fontData.glyphMetricsMap.size())
+    {
+        return false;
+    }
+    for (const auto& pair : fontData.glyphMetricsMap)
+    {
+        auto decoded = compactDecodedFontData.glyphMetricsMap.find(pair.first);
+        if (decoded == compactDecodedFontData.glyphMetricsMap.end() ||
+            decoded->second.width_px != pair.second.width_px ||
+            decoded->second.height_px != pair.second.height_px ||
+            decoded->second.horiBearingX_px != pair.second.horiBearingX_px ||
+            decoded->second.horiBearingY_px != pair.second.horiBearingY_px ||
+            decoded->second.horiAdvance_px != pair.second.horiAdvance_px ||
+            decoded->second.vertBearingX_px != pair.second.vertBearingX_px ||
+            decoded->second.vertBearingY_px != pair.second.vertBearingY_px ||
+            decoded->second.vertAdvance_px != pair.second.vertAdvance_px ||
+            decoded->second.channel != pair.second.channel ||
+            std::fabs(decoded->second.textureLeft - pair.second.textureLeft) > 1.0f / 65535.0f ||
+            std::fabs(decoded->second.textureRight - pair.second.textureRight) > 1.0f / 65535.0f ||
+            std::fabs(decoded->second.textureBottom - pair.second.textureBottom) > 1.0f / 65535.0f ||
+            std::fabs(decoded->second.textureTop - pair.second.textureTop) > 1.0f / 65535.0f)
+        {
+            return false;
+        }
+    }
+
+    buffer.clear();
+    ftss::TextureData decodedTextureData;
+    if (!ftss::EncodeRawTextureData(buffer, textureData) ||
+        !ftss::DecodeRawTextureData(decodedTextureData, buffer.data(), buffer.size()) ||
+        decodedTextureData.width != textureData.width ||
+        decodedTextureData.height != textureData.height ||
+        decodedTextureData.bytesPerPixel != textureData.bytesPerPixel ||
+        !std::equal(textureData.data, textureData.data + textureData.GetSize(), decodedTextureData.data))
+    {
+        return false;
+    }
+
+    // a bundle with the font and a metrics only copy of it at another size,
+    // the views point straight into the buffer
+    std::vector<ftss::FontBundleSource> fontBundleSources(2);
+    fontBundleSources[0].fontName = "Test";
+    fontBundleSources[0].fontSize_px = 48;
+    fontBundleSources[0].fontData = fontData;
+    if (!fontBundleSources[0].textureData.Allocate(textureData.width, textureData.height, textureData.bytesPerPixel))
+    {
+        return false;
+    }
+    std::copy(textureData.data, textureData.data + textureData.GetSize(), fontBundleSources[0].textureData.data);
+    fontBundleSources[1].fontName = "Test";
+    fontBundleSources[1].fontSize_px = 49;
+    fontBundleSources[1].fontData = fontData;
+
+    buffer.clear();
+    ftss::FontBundle fontBundle;
+    ftss::FontBundleView fontBundleView;
+    ftss::FontBundleView metricsOnlyView;
+    if (!ftss::EncodeFontBundle(buffer, fontBundleSources) ||
+        !fontBundle.Open(buffer.data(), buffer.size()) ||
+        fontBundle.GetFontCount() != 2 ||
+        !fontBundle.FindFont(fontBundleView, "Test", 48) ||
+        !fontBundle.FindFont(metricsOnlyView, "Test", 49) ||
+        fontBundle.FindFont(fontBundleView, "Test", 50) ||
+        fontBundle.FindFont(fontBundleView, "Tes", 48))
+    {
+        return false;
+    }
+
+    ftss::FontData bundleFontData;
+    ftss::ConvertFromFontBundleView(bundleFontData, fontBundleView);
+    return bundleFontData == fontData &&
+        metricsOnlyView.textureData == nullptr &&
+        ftss::FontBundleView().FindGlyph('A') == nullptr &&
+        ftss::FontBundleView().FindSubpixelVariant('A', 1) == nullptr &&
+        fontBundleView.textureWidth == textureData.width &&
+        fontBundleView.textureHeight == textureData.height &&
+        fontBundleView.bytesPerPixel == textureData.bytesPerPixel &&
+        reinterpret_cast<size_t>(fontBundleView.textureData) % ftss::FONT_BUNDLE_ALIGNMENT == reinterpret_cast<size_t>(buffer.data()) % ftss::FONT_BUNDLE_ALIGNMENT &&
+        std::equal(textureData.data, textureData.data + textureData.GetSize(), fontBundleView.textureData);
+}
+
+// The glyphs are packed in the iteration order of an unordered_map, which
+// differs between standard libraries. The hashes go over the glyphs in
+// character order and leave out where a glyph ended up in the texture, so
+// they only change when a glyph renders or measures differently.
+unsigned long long HashMetrics(const ftss::FontData& fontData)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    HashBytes(hash, &fontData.lineSpacing_px, 4);
+    for (unsigned int c = 0; c < 256; ++c)
+    {
+        auto iter = fontData.glyphMetricsMap.find(static_cast<unsigned char>(c));
+        if (iter == fontData.glyphMetricsMap.end())
+        {
+            continue;
+        }
+
+        const ftss::GlyphMetrics& metrics = iter->second;
+        const unsigned int values[] = {
+            c,
+            metrics.width_px,
+            metrics.height_px,
+            metrics.horiBearingX_px,
+            metrics.horiBearingY_px,
+            metrics.horiAdvance_px,
+            metrics.vertBearingX_px,
+            metrics.vertBearingY_px,
+            metrics.vertAdvance_px,
+            metrics.channel };
+        HashBytes(hash, values, sizeof(values));
+    }
+    return hash;
+}
+
+unsigned long long HashPixels(const ftss::TextureData& textureData, const ftss::FontData& fontData)
+{
+    unsigned long long hash = 14695981039346656037ull;
+
+    // packing order changes the width only by where the spacing goes, never in total
+    const unsigned int size[] = { textureData.width, textureData.height, textureData.bytesPerPixel };
+    HashBytes(hash, size, sizeof(size));
+
+    for (unsigned int c = 0; c < 256; ++c)
+    {
+        auto iter = fontData.glyphMetricsMap.find(static_cast<unsigned char>(c));
+        if (iter == fontData.glyphMetricsMap.end())
+        {
+            continue;
+        }
+
+        const ftss::GlyphMetrics& metrics = iter->second;
+        unsigned int x = static_cast<unsigned int>(std::lround(std::min(metrics.textureLeft, metrics.textureRight) * textureData.width));
+        unsigned int y = ftss::GetTextureTopRow(metrics.textureBottom, metrics.textureTop, textureData.height);
+        if (x + metrics.width_px > textureData.width || y + metrics.height_px > textureData.height)
+        {
+            // can't happen for a valid atlas, make sure the hash can't match
+            HashBytes(hash, &c, sizeof(c));
+            continue;
+        }
+
+        for (unsigned int j = 0; j < metrics.height_px; ++j)
+        {
+            const unsigned char* row = textureData.data + (static_cast<size_t>(y + j) * textureData.width + x) * textureData.bytesPerPixel;
+            HashBytes(hash, row, static_cast<size_t>(metrics.width_px) * textureData.bytesPerPixel);
+        }
+    }
+    return hash;
+}
+
+// 64 bit FNV-1a
+void HashBytes(unsigned long long& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+// One test case per line: <size> <horizontal_spacing> <vertical_spacing>
+// <metrics_hash> <pixel_hash> <font_file>, the font file takes the rest of
+// the line. Lines starting with # are comments.
+bool LoadGoldenFile(std::vector<TestCase>& testCases, const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open())
+    {
+        std::cerr << "ERROR: could not open " << filePath << std::endl;
+        return false;
+    }
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream lineStream(line);
+        TestCase testCase;
+        lineStream >> testCase.fontHeightInPixels >> testCase.horizontalSpacing >> testCase.verticalSpacing
+            >> std::hex >> testCase.metricsHash >> testCase.pixelHash >> std::dec >> std::ws;
+        std::getline(lineStream, testCase.fontFile);
+        if (lineStream.fail() || testCase.fontFile.empty())
+        {
+            std::cerr << "ERROR: " << filePath << ":" << lineNumber << " isn't a test case" << std::endl;
+            return false;
+        }
+        testCases.push_back(testCase);
+    }
+
+    return true;
+}
+
+bool WriteGoldenFile(const std::vector<TestCase>& testCases, const std::string& filePath)
+{
+    std::ofstream file(filePath);
+    if (!file.is_open())
+    {
+        std::cerr << "ERROR: could not open " << filePath << std::endl;
+        return false;
+    }
+
+    file << "# Written by FontToSpriteSheetTests golden <test_directory> --update, the hashes\n";
+    file << "# depend on the FreeType version that rendered the glyphs.\n";
+    file << "# <size> <horizontal_spacing> <vertical_spacing> <metrics_hash> <pixel_hash> <font_file>\n";
+    file << std::hex << std::setfill('0');
+    for (const TestCase& testCase : testCases)
+    {
+        file << std::dec << testCase.fontHeightInPixels << " " << testCase.horizontalSpacing << " " << testCase.verticalSpacing << " ";
+        file << std::hex << std::setw(16) << testCase.metricsHash << " " << std::setw(16) << testCase.pixelHash << " ";
+        file << testCase.fontFile << "\n";
+    }
+
+    return file.good();
+}
+
+// <name> <value> per line, "margin" is how far above its budget a
+// measurement may go as a fraction. Lines starting with # are comments.
+bool LoadBudgetFile(std::vector<std::pair<std::string, double>>& budgets, double& margin, const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open())
+    {
+        std::cerr << "ERROR: could not open " << filePath << std::endl;
+        return false;
+    }
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream lineStream(line);
+        std::string name;
+        double value = 0.0;
+        lineStream >> name >> value;
+        if (lineStream.fail() || value < 0.0)
+        {
+            std::cerr << "ERROR: " << filePath << ":" << lineNumber << " isn't a budget" << std::endl;
+            return false;
+        }
+
+        if (name == "margin")
+        {
+            margin = value;
+        }
+        else
+        {
+            budgets.push_back(std::make_pair(name, value));
+        }
+    }
+
+    return true;
+}
+
+size_t GetPeakMemory_kB()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss) / 1024; // bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss); // kilobytes on Linux
+#endif
+#endif
+}
+
+double GetElapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}